@@ -1381,6 +1381,41 @@ good_area:
 		return;
 	}
 
+	/*
+	 * Try to service the fault under the per-VMA lock so that a
+	 * concurrent mmap()/munmap() in another thread only waits for
+	 * the VMA lookup above, not for the whole fault.  A writer
+	 * draining the VMA, or a handler that needs mmap_lock after
+	 * all, pushes us onto the regular path below.
+	 */
+	if (IS_ENABLED(CONFIG_PER_VMA_LOCK) &&
+	    !(flags & FAULT_FLAG_TRIED) && vma_can_lock_fault(vma) &&
+	    vma_start_read(vma)) {
+		mmap_read_unlock(mm);
+		fault = handle_mm_fault(vma, address,
+					flags | FAULT_FLAG_VMA_LOCK, regs);
+		vma_end_read(vma);
+
+		if (!(fault & VM_FAULT_RETRY))
+			goto done;
+
+		if (fault_signal_pending(fault, regs)) {
+			if (!user_mode(regs))
+				kernelmode_fixup_or_oops(regs, error_code,
+							 address, SIGBUS,
+							 BUS_ADRERR,
+							 ARCH_DEFAULT_PKEY);
+			return;
+		}
+		/*
+		 * Fall back to the mmap_lock path.  The fault has been
+		 * tried once, which also keeps us from re-entering the
+		 * VMA lock attempt above.
+		 */
+		flags |= FAULT_FLAG_TRIED;
+		goto retry;
+	}
+
 	/*
 	 * If for any reason at all we couldn't handle the fault,
 	 * make sure we exit gracefully rather than endlessly redo
@@ -1419,6 +1454,7 @@ good_area:
 	}
 
 	mmap_read_unlock(mm);
+done:
 	if (likely(!(fault & VM_FAULT_ERROR)))
 		return;
 
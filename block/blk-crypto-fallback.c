@@ -251,6 +251,83 @@ static void blk_crypto_dun_to_iv(const u64 dun[BLK_CRYPTO_DUN_ARRAY_SIZE],
 		iv->dun[i] = cpu_to_le64(dun[i]);
 }
 
+/*
+ * Number of skcipher requests kept in flight while en/decrypting a bio.
+ * A depth of two is enough to overlap submission of one data unit with
+ * completion of the previous one on asynchronous crypto engines.
+ * Synchronous tfms (e.g. the x86 SIMD AES-XTS implementations) complete
+ * inline, for which this degenerates to fully serial operation.
+ */
+#define BLK_CRYPTO_NUM_PIPELINE_SLOTS 2
+
+struct blk_crypto_pipeline_slot {
+	struct skcipher_request *ciph_req;
+	struct crypto_wait wait;
+	union blk_crypto_iv iv;
+	struct scatterlist src, dst;
+	int rc;
+};
+
+/*
+ * Allocate and set up the skcipher requests for a pipeline.  @slots must be
+ * zero-initialized by the caller; on failure the already-allocated requests
+ * are left for blk_crypto_free_pipeline() to clean up.
+ */
+static bool
+blk_crypto_fallback_init_pipeline(struct blk_crypto_keyslot *slot,
+				  struct blk_crypto_pipeline_slot *slots,
+				  unsigned int data_unit_size)
+{
+	int k;
+
+	for (k = 0; k < BLK_CRYPTO_NUM_PIPELINE_SLOTS; k++) {
+		struct blk_crypto_pipeline_slot *s = &slots[k];
+
+		crypto_init_wait(&s->wait);
+		if (!blk_crypto_fallback_alloc_cipher_req(slot, &s->ciph_req,
+							  &s->wait))
+			return false;
+		sg_init_table(&s->src, 1);
+		sg_init_table(&s->dst, 1);
+		skcipher_request_set_crypt(s->ciph_req, &s->src, &s->dst,
+					   data_unit_size, s->iv.bytes);
+	}
+	return true;
+}
+
+/*
+ * Wait for the request in @s, if one is in flight, and return its final
+ * status.  Idempotent: once a request has completed, its status is simply
+ * returned again.
+ */
+static int blk_crypto_pipeline_wait(struct blk_crypto_pipeline_slot *s)
+{
+	s->rc = crypto_wait_req(s->rc, &s->wait);
+	return s->rc;
+}
+
+/* Wait for all in-flight requests; returns the first error, if any. */
+static int blk_crypto_drain_pipeline(struct blk_crypto_pipeline_slot *slots)
+{
+	int k, err, ret = 0;
+
+	for (k = 0; k < BLK_CRYPTO_NUM_PIPELINE_SLOTS; k++) {
+		err = blk_crypto_pipeline_wait(&slots[k]);
+		if (err && !ret)
+			ret = err;
+	}
+	return ret;
+}
+
+/* Only safe once the pipeline has been drained. */
+static void blk_crypto_free_pipeline(struct blk_crypto_pipeline_slot *slots)
+{
+	int k;
+
+	for (k = 0; k < BLK_CRYPTO_NUM_PIPELINE_SLOTS; k++)
+		skcipher_request_free(slots[k].ciph_req);
+}
+
 /*
  * The crypto API fallback's encryption routine.
  * Allocate a bounce bio for encryption, encrypt the input bio using crypto API,
@@ -260,16 +337,14 @@ static void blk_crypto_dun_to_iv(const u64 dun[BLK_CRYPTO_DUN_ARRAY_SIZE],
  */
 static bool blk_crypto_fallback_encrypt_bio(struct bio **bio_ptr)
 {
+	struct blk_crypto_pipeline_slot slots[BLK_CRYPTO_NUM_PIPELINE_SLOTS] = {};
 	struct bio *src_bio, *enc_bio;
 	struct bio_crypt_ctx *bc;
 	struct blk_crypto_keyslot *slot;
 	int data_unit_size;
-	struct skcipher_request *ciph_req = NULL;
-	DECLARE_CRYPTO_WAIT(wait);
 	u64 curr_dun[BLK_CRYPTO_DUN_ARRAY_SIZE];
-	struct scatterlist src, dst;
-	union blk_crypto_iv iv;
 	unsigned int i, j;
+	unsigned int n = 0;
 	bool ret = false;
 	blk_status_t blk_st;
 
@@ -299,18 +374,13 @@ static bool blk_crypto_fallback_encrypt_bio(struct bio **bio_ptr)
 		goto out_put_enc_bio;
 	}
 
-	/* and then allocate an skcipher_request for it */
-	if (!blk_crypto_fallback_alloc_cipher_req(slot, &ciph_req, &wait)) {
+	/* and then allocate the skcipher_requests for it */
+	if (!blk_crypto_fallback_init_pipeline(slot, slots, data_unit_size)) {
 		src_bio->bi_status = BLK_STS_RESOURCE;
-		goto out_release_keyslot;
+		goto out_free_pipeline;
 	}
 
 	memcpy(curr_dun, bc->bc_dun, sizeof(curr_dun));
-	sg_init_table(&src, 1);
-	sg_init_table(&dst, 1);
-
-	skcipher_request_set_crypt(ciph_req, &src, &dst, data_unit_size,
-				   iv.bytes);
 
 	/* Encrypt each page in the bounce bio */
 	for (i = 0; i < enc_bio->bi_vcnt; i++) {
@@ -326,40 +396,49 @@ static bool blk_crypto_fallback_encrypt_bio(struct bio **bio_ptr)
 			goto out_free_bounce_pages;
 		}
 
-		sg_set_page(&src, plaintext_page, data_unit_size,
-			    enc_bvec->bv_offset);
-		sg_set_page(&dst, ciphertext_page, data_unit_size,
-			    enc_bvec->bv_offset);
-
 		/* Encrypt each data unit in this page */
 		for (j = 0; j < enc_bvec->bv_len; j += data_unit_size) {
-			blk_crypto_dun_to_iv(curr_dun, &iv);
-			if (crypto_wait_req(crypto_skcipher_encrypt(ciph_req),
-					    &wait)) {
+			struct blk_crypto_pipeline_slot *s =
+				&slots[n++ % BLK_CRYPTO_NUM_PIPELINE_SLOTS];
+
+			/* Reclaim the slot before reusing it. */
+			if (blk_crypto_pipeline_wait(s)) {
 				i++;
 				src_bio->bi_status = BLK_STS_IOERR;
 				goto out_free_bounce_pages;
 			}
+			blk_crypto_dun_to_iv(curr_dun, &s->iv);
+			sg_set_page(&s->src, plaintext_page, data_unit_size,
+				    enc_bvec->bv_offset + j);
+			sg_set_page(&s->dst, ciphertext_page, data_unit_size,
+				    enc_bvec->bv_offset + j);
+			s->rc = crypto_skcipher_encrypt(s->ciph_req);
 			bio_crypt_dun_increment(curr_dun, 1);
-			src.offset += data_unit_size;
-			dst.offset += data_unit_size;
 		}
 	}
 
+	if (blk_crypto_drain_pipeline(slots)) {
+		i = enc_bio->bi_vcnt;
+		src_bio->bi_status = BLK_STS_IOERR;
+		goto out_free_bounce_pages;
+	}
+
 	enc_bio->bi_private = src_bio;
 	enc_bio->bi_end_io = blk_crypto_fallback_encrypt_endio;
 	*bio_ptr = enc_bio;
 	ret = true;
 
 	enc_bio = NULL;
-	goto out_free_ciph_req;
+	goto out_free_pipeline;
 
 out_free_bounce_pages:
+	/* Quiesce any in-flight requests before freeing their pages. */
+	blk_crypto_drain_pipeline(slots);
 	while (i > 0)
 		mempool_free(enc_bio->bi_io_vec[--i].bv_page,
 			     blk_crypto_bounce_page_pool);
-out_free_ciph_req:
-	skcipher_request_free(ciph_req);
+out_free_pipeline:
+	blk_crypto_free_pipeline(slots);
 out_release_keyslot:
 	blk_crypto_put_keyslot(slot);
 out_put_enc_bio:
@@ -380,15 +459,13 @@ static void blk_crypto_fallback_decrypt_bio(struct work_struct *work)
 	struct bio *bio = f_ctx->bio;
 	struct bio_crypt_ctx *bc = &f_ctx->crypt_ctx;
 	struct blk_crypto_keyslot *slot;
-	struct skcipher_request *ciph_req = NULL;
-	DECLARE_CRYPTO_WAIT(wait);
+	struct blk_crypto_pipeline_slot slots[BLK_CRYPTO_NUM_PIPELINE_SLOTS] = {};
 	u64 curr_dun[BLK_CRYPTO_DUN_ARRAY_SIZE];
-	union blk_crypto_iv iv;
-	struct scatterlist sg;
 	struct bio_vec bv;
 	struct bvec_iter iter;
 	const int data_unit_size = bc->bc_key->crypto_cfg.data_unit_size;
 	unsigned int i;
+	unsigned int n = 0;
 	blk_status_t blk_st;
 
 	/*
@@ -402,38 +479,40 @@ static void blk_crypto_fallback_decrypt_bio(struct work_struct *work)
 		goto out_no_keyslot;
 	}
 
-	/* and then allocate an skcipher_request for it */
-	if (!blk_crypto_fallback_alloc_cipher_req(slot, &ciph_req, &wait)) {
+	/* and then allocate the skcipher_requests for it */
+	if (!blk_crypto_fallback_init_pipeline(slot, slots, data_unit_size)) {
 		bio->bi_status = BLK_STS_RESOURCE;
 		goto out;
 	}
 
 	memcpy(curr_dun, bc->bc_dun, sizeof(curr_dun));
-	sg_init_table(&sg, 1);
-	skcipher_request_set_crypt(ciph_req, &sg, &sg, data_unit_size,
-				   iv.bytes);
 
 	/* Decrypt each segment in the bio */
 	__bio_for_each_segment(bv, bio, iter, f_ctx->crypt_iter) {
 		struct page *page = bv.bv_page;
 
-		sg_set_page(&sg, page, data_unit_size, bv.bv_offset);
-
-		/* Decrypt each data unit in the segment */
+		/* Decrypt each data unit in the segment (in place) */
 		for (i = 0; i < bv.bv_len; i += data_unit_size) {
-			blk_crypto_dun_to_iv(curr_dun, &iv);
-			if (crypto_wait_req(crypto_skcipher_decrypt(ciph_req),
-					    &wait)) {
-				bio->bi_status = BLK_STS_IOERR;
+			struct blk_crypto_pipeline_slot *s =
+				&slots[n++ % BLK_CRYPTO_NUM_PIPELINE_SLOTS];
+
+			/* Reclaim the slot before reusing it. */
+			if (blk_crypto_pipeline_wait(s))
 				goto out;
-			}
+			blk_crypto_dun_to_iv(curr_dun, &s->iv);
+			sg_set_page(&s->src, page, data_unit_size,
+				    bv.bv_offset + i);
+			sg_set_page(&s->dst, page, data_unit_size,
+				    bv.bv_offset + i);
+			s->rc = crypto_skcipher_decrypt(s->ciph_req);
 			bio_crypt_dun_increment(curr_dun, 1);
-			sg.offset += data_unit_size;
 		}
 	}
 
 out:
-	skcipher_request_free(ciph_req);
+	if (blk_crypto_drain_pipeline(slots))
+		bio->bi_status = BLK_STS_IOERR;
+	blk_crypto_free_pipeline(slots);
 	blk_crypto_put_keyslot(slot);
 out_no_keyslot:
 	mempool_free(f_ctx, bio_fallback_crypt_ctx_pool);
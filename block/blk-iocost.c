@@ -2095,6 +2095,12 @@ static void ioc_forgive_debts(struct ioc *ioc, u64 usage_us_sum, int nr_debtors,
 	nr_cycles = dur + ioc->dfgv_period_rem;
 	ioc->dfgv_period_rem = do_div(nr_cycles, DFGV_PERIOD);
 
+	/*
+	 * A long idle period accumulates a huge @nr_cycles; cap the shift
+	 * count so the halvings below stay defined.
+	 */
+	nr_cycles = min_t(u64, nr_cycles, BITS_PER_LONG - 1);
+
 	list_for_each_entry(iocg, &ioc->active_iocgs, active_list) {
 		u64 __maybe_unused old_debt, __maybe_unused old_delay;
 
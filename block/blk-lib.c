@@ -7,6 +7,7 @@
 #include <linux/bio.h>
 #include <linux/blkdev.h>
 #include <linux/scatterlist.h>
+#include <linux/sizes.h>
 
 #include "blk.h"
 
@@ -86,6 +87,16 @@ int __blkdev_issue_discard(struct block_device *bdev, sector_t sector,
 }
 EXPORT_SYMBOL(__blkdev_issue_discard);
 
+/*
+ * There is no generic way to throttle discards once they sit in the
+ * dispatch queues, so bound how much blkdev_issue_discard() chains up
+ * and waits for per round instead.  Each round boundary drains the
+ * outstanding discards and lets foreground I/O submitted meanwhile
+ * interleave, so a device-wide discard (mkfs, fstrim) no longer parks
+ * everything else behind a single monolithic wait.
+ */
+#define BLK_DISCARD_BATCH_SECTORS	((sector_t)SZ_4G >> SECTOR_SHIFT)
+
 /**
  * blkdev_issue_discard - queue a discard
  * @bdev:	blockdev to issue discard for
@@ -99,19 +110,32 @@ EXPORT_SYMBOL(__blkdev_issue_discard);
 int blkdev_issue_discard(struct block_device *bdev, sector_t sector,
 		sector_t nr_sects, gfp_t gfp_mask)
 {
-	struct bio *bio = NULL;
 	struct blk_plug plug;
-	int ret;
+	struct bio *bio;
+	int ret = 0;
 
-	blk_start_plug(&plug);
-	ret = __blkdev_issue_discard(bdev, sector, nr_sects, gfp_mask, &bio);
-	if (!ret && bio) {
-		ret = submit_bio_wait(bio);
-		if (ret == -EOPNOTSUPP)
-			ret = 0;
-		bio_put(bio);
+	while (nr_sects) {
+		sector_t batch = min_t(sector_t, nr_sects,
+				       BLK_DISCARD_BATCH_SECTORS);
+
+		bio = NULL;
+		blk_start_plug(&plug);
+		ret = __blkdev_issue_discard(bdev, sector, batch, gfp_mask,
+					     &bio);
+		if (!ret && bio) {
+			ret = submit_bio_wait(bio);
+			if (ret == -EOPNOTSUPP)
+				ret = 0;
+			bio_put(bio);
+		}
+		blk_finish_plug(&plug);
+		if (ret)
+			break;
+
+		sector += batch;
+		nr_sects -= batch;
+		cond_resched();
 	}
-	blk_finish_plug(&plug);
 
 	return ret;
 }
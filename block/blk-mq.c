@@ -338,6 +338,22 @@ void blk_rq_init(struct request_queue *q, struct request *rq)
 }
 EXPORT_SYMBOL(blk_rq_init);
 
+/* Set start and alloc time when the allocated request is actually used */
+static inline void blk_mq_rq_time_init(struct request *rq, u64 alloc_time_ns)
+{
+	if (blk_mq_need_time_stamp(rq))
+		rq->start_time_ns = ktime_get_ns();
+	else
+		rq->start_time_ns = 0;
+
+#ifdef CONFIG_BLK_RQ_ALLOC_TIME
+	if (blk_queue_rq_alloc_time(rq->q))
+		rq->alloc_time_ns = alloc_time_ns ?: rq->start_time_ns;
+	else
+		rq->alloc_time_ns = 0;
+#endif
+}
+
 static struct request *blk_mq_rq_ctx_init(struct blk_mq_alloc_data *data,
 		struct blk_mq_tags *tags, unsigned int tag, u64 alloc_time_ns)
 {
@@ -366,14 +382,8 @@ static struct request *blk_mq_rq_ctx_init(struct blk_mq_alloc_data *data,
 	}
 	rq->timeout = 0;
 
-	if (blk_mq_need_time_stamp(rq))
-		rq->start_time_ns = ktime_get_ns();
-	else
-		rq->start_time_ns = 0;
+	blk_mq_rq_time_init(rq, alloc_time_ns);
 	rq->part = NULL;
-#ifdef CONFIG_BLK_RQ_ALLOC_TIME
-	rq->alloc_time_ns = alloc_time_ns;
-#endif
 	rq->io_start_time_ns = 0;
 	rq->stats_sectors = 0;
 	rq->nr_phys_segments = 0;
@@ -805,6 +815,9 @@ bool blk_update_request(struct request *req, blk_status_t error,
 
 	blk_account_io_completion(req, nr_bytes);
 
+	if (blk_queue_is_zoned(req->q))
+		blk_zone_update_wp_cache(req, error, nr_bytes);
+
 	total_bytes = 0;
 	while (req->bio) {
 		struct bio *bio = req->bio;
@@ -2778,6 +2791,7 @@ static inline struct request *blk_mq_get_cached_request(struct request_queue *q,
 	plug->cached_rq = rq_list_next(rq);
 	rq_qos_throttle(q, *bio);
 
+	blk_mq_rq_time_init(rq, 0);
 	rq->cmd_flags = (*bio)->bi_opf;
 	INIT_LIST_HEAD(&rq->queuelist);
 	return rq;
@@ -4599,6 +4613,7 @@ static void blk_mq_poll_stats_fn(struct blk_stat_callback *cb)
 static unsigned long blk_mq_poll_nsecs(struct request_queue *q,
 				       struct request *rq)
 {
+	struct blk_rq_stat *stat;
 	unsigned long ret = 0;
 	int bucket;
 
@@ -4610,20 +4625,28 @@ static unsigned long blk_mq_poll_nsecs(struct request_queue *q,
 		return 0;
 
 	/*
-	 * As an optimistic guess, use half of the mean service time
-	 * for this type of request. We can (and should) make this smarter.
-	 * For instance, if the completion latencies are tight, we can
-	 * get closer than just half the mean. This is especially
-	 * important on devices where the completion latencies are longer
-	 * than ~10 usec. We do use the stats for the relevant IO size
-	 * if available which does lead to better estimates.
+	 * Use the stats for the relevant IO size if available, which does
+	 * lead to better estimates.  Half of the mean service time is a
+	 * safe guess for widely spread completion times.  When the window's
+	 * completions are tightly clustered (the slowest was within twice
+	 * the fastest) we can sleep much closer to the expected completion
+	 * and still wake up in time to poll for it, which matters on
+	 * devices whose service times are well past the wakeup latency.
+	 * Never sleep beyond the fastest completion seen in the window, so
+	 * a best-case request still gets polled for, not slept through.
 	 */
 	bucket = blk_mq_poll_stats_bkt(rq);
 	if (bucket < 0)
 		return ret;
 
-	if (q->poll_stat[bucket].nr_samples)
-		ret = (q->poll_stat[bucket].mean + 1) / 2;
+	stat = &q->poll_stat[bucket];
+	if (stat->nr_samples) {
+		if (stat->max <= 2 * stat->min)
+			ret = stat->mean - (stat->mean >> 2);
+		else
+			ret = (stat->mean + 1) / 2;
+		ret = min_t(unsigned long, ret, stat->min);
+	}
 
 	return ret;
 }
@@ -124,6 +124,112 @@ unsigned int blkdev_nr_zones(struct gendisk *disk)
 }
 EXPORT_SYMBOL_GPL(blkdev_nr_zones);
 
+/**
+ * bdev_zone_wp_offset - Get the cached write pointer offset of a zone
+ * @bdev:	Target block device
+ * @sector:	Sector identifying the zone (any sector within the zone)
+ * @wp_ofst:	Output write pointer offset, in sectors from the zone start
+ *
+ * Description:
+ *    Return the write pointer position of the zone containing @sector as
+ *    cached by the block layer from write completions, avoiding a report
+ *    zones command.  A full zone reports its zone length.  The cache is a
+ *    hint: it is maintained only for I/O issued through the block layer,
+ *    so passthrough writes or device-side activity are not reflected, and
+ *    a zone whose last write failed reports -ENODATA until the next disk
+ *    zone revalidation.  Returns -EOPNOTSUPP if @bdev is not zoned, the
+ *    cache is not initialized or the zone is conventional.
+ */
+int bdev_zone_wp_offset(struct block_device *bdev, sector_t sector,
+			sector_t *wp_ofst)
+{
+	struct request_queue *q = bdev_get_queue(bdev);
+	u32 ofst;
+
+	if (!blk_queue_is_zoned(q) || !q->seq_zones_wp_ofst)
+		return -EOPNOTSUPP;
+
+	if (sector >= get_capacity(bdev->bd_disk))
+		return -EINVAL;
+
+	if (!blk_queue_zone_is_seq(q, sector))
+		return -EOPNOTSUPP;
+
+	ofst = READ_ONCE(q->seq_zones_wp_ofst[blk_queue_zone_no(q, sector)]);
+	if (ofst == BLK_ZONE_WP_UNKNOWN)
+		return -ENODATA;
+
+	*wp_ofst = ofst;
+	return 0;
+}
+EXPORT_SYMBOL_GPL(bdev_zone_wp_offset);
+
+/*
+ * Update the cached write pointer offsets from a completed request.
+ * Called from blk_update_request() before the completed bios are ended.
+ * The cache is a hint and the updates are racy by design: concurrent
+ * writers to one zone are already serialized by the zone write lock or,
+ * for zone append, converge to the same device-side write pointer.
+ */
+void blk_zone_update_wp_cache(struct request *rq, blk_status_t error,
+			      unsigned int nr_bytes)
+{
+	struct request_queue *q = rq->q;
+	sector_t zone_sectors = blk_queue_zone_sectors(q);
+	sector_t sector = blk_rq_pos(rq);
+	unsigned int zno;
+	u32 wp_ofst;
+
+	if (!q->seq_zones_wp_ofst || blk_rq_is_passthrough(rq))
+		return;
+
+	switch (req_op(rq)) {
+	case REQ_OP_WRITE:
+	case REQ_OP_WRITE_ZEROES:
+	case REQ_OP_ZONE_APPEND:
+		if (!blk_queue_zone_is_seq(q, sector))
+			return;
+		zno = blk_queue_zone_no(q, sector);
+		if (error) {
+			/* The write pointer is anyone's guess now */
+			WRITE_ONCE(q->seq_zones_wp_ofst[zno],
+				   BLK_ZONE_WP_UNKNOWN);
+			return;
+		}
+		/*
+		 * For zone append, blk_rq_pos() is the actual write
+		 * position set by the driver at completion time.  A
+		 * successful completion always tells us where the write
+		 * pointer now is, so this also self-heals a zone that was
+		 * marked unknown by an earlier failure.
+		 */
+		wp_ofst = (sector & (zone_sectors - 1)) +
+			  (nr_bytes >> SECTOR_SHIFT);
+		WRITE_ONCE(q->seq_zones_wp_ofst[zno], wp_ofst);
+		return;
+	case REQ_OP_ZONE_RESET:
+		if (!error)
+			WRITE_ONCE(q->seq_zones_wp_ofst[blk_queue_zone_no(q, sector)], 0);
+		return;
+	case REQ_OP_ZONE_FINISH:
+		if (!error)
+			WRITE_ONCE(q->seq_zones_wp_ofst[blk_queue_zone_no(q, sector)],
+				   zone_sectors);
+		return;
+	case REQ_OP_ZONE_RESET_ALL:
+		if (error)
+			return;
+		for (zno = 0; zno < q->nr_zones; zno++) {
+			if (!q->conv_zones_bitmap ||
+			    !test_bit(zno, q->conv_zones_bitmap))
+				WRITE_ONCE(q->seq_zones_wp_ofst[zno], 0);
+		}
+		return;
+	default:
+		return;
+	}
+}
+
 /**
  * blkdev_report_zones - Get zones information
  * @bdev:	Target block device
@@ -456,12 +562,15 @@ void blk_queue_free_zone_bitmaps(struct request_queue *q)
 	q->conv_zones_bitmap = NULL;
 	kfree(q->seq_zones_wlock);
 	q->seq_zones_wlock = NULL;
+	kfree(q->seq_zones_wp_ofst);
+	q->seq_zones_wp_ofst = NULL;
 }
 
 struct blk_revalidate_zone_args {
 	struct gendisk	*disk;
 	unsigned long	*conv_zones_bitmap;
 	unsigned long	*seq_zones_wlock;
+	u32		*seq_zones_wp_ofst;
 	unsigned int	nr_zones;
 	sector_t	zone_sectors;
 	sector_t	sector;
@@ -512,6 +621,14 @@ static int blk_revalidate_zone_cb(struct blk_zone *zone, unsigned int idx,
 		return -ENODEV;
 	}
 
+	if (!args->seq_zones_wp_ofst) {
+		args->seq_zones_wp_ofst = kcalloc_node(args->nr_zones,
+					sizeof(*args->seq_zones_wp_ofst),
+					GFP_NOIO, q->node);
+		if (!args->seq_zones_wp_ofst)
+			return -ENOMEM;
+	}
+
 	/* Check zone type */
 	switch (zone->type) {
 	case BLK_ZONE_TYPE_CONVENTIONAL:
@@ -531,6 +648,20 @@ static int blk_revalidate_zone_cb(struct blk_zone *zone, unsigned int idx,
 			if (!args->seq_zones_wlock)
 				return -ENOMEM;
 		}
+
+		/* Seed the write pointer cache from the report */
+		switch (zone->cond) {
+		case BLK_ZONE_COND_FULL:
+			args->seq_zones_wp_ofst[idx] = zone->len;
+			break;
+		case BLK_ZONE_COND_READONLY:
+		case BLK_ZONE_COND_OFFLINE:
+			args->seq_zones_wp_ofst[idx] = BLK_ZONE_WP_UNKNOWN;
+			break;
+		default:
+			args->seq_zones_wp_ofst[idx] = zone->wp - zone->start;
+			break;
+		}
 		break;
 	default:
 		pr_warn("%s: Invalid zone type 0x%x at sectors %llu\n",
@@ -608,6 +739,7 @@ int blk_revalidate_disk_zones(struct gendisk *disk,
 		q->nr_zones = args.nr_zones;
 		swap(q->seq_zones_wlock, args.seq_zones_wlock);
 		swap(q->conv_zones_bitmap, args.conv_zones_bitmap);
+		swap(q->seq_zones_wp_ofst, args.seq_zones_wp_ofst);
 		if (update_driver_data)
 			update_driver_data(disk);
 		ret = 0;
@@ -619,6 +751,7 @@ int blk_revalidate_disk_zones(struct gendisk *disk,
 
 	kfree(args.seq_zones_wlock);
 	kfree(args.conv_zones_bitmap);
+	kfree(args.seq_zones_wp_ofst);
 	return ret;
 }
 EXPORT_SYMBOL_GPL(blk_revalidate_disk_zones);
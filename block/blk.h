@@ -394,9 +394,14 @@ static inline int blk_iolatency_init(struct request_queue *q) { return 0; }
 #ifdef CONFIG_BLK_DEV_ZONED
 void blk_queue_free_zone_bitmaps(struct request_queue *q);
 void blk_queue_clear_zone_settings(struct request_queue *q);
+void blk_zone_update_wp_cache(struct request *rq, blk_status_t error,
+			      unsigned int nr_bytes);
 #else
 static inline void blk_queue_free_zone_bitmaps(struct request_queue *q) {}
 static inline void blk_queue_clear_zone_settings(struct request_queue *q) {}
+static inline void blk_zone_update_wp_cache(struct request *rq,
+					    blk_status_t error,
+					    unsigned int nr_bytes) {}
 #endif
 
 int blk_alloc_ext_minor(void);
@@ -81,11 +81,20 @@ struct dd_per_prio {
 	struct io_stats_per_prio stats;
 };
 
+/* Bits for deadline_data.run_state. */
+#define DD_DISPATCHING	0
+
 struct deadline_data {
 	/*
 	 * run time data
 	 */
 
+	/*
+	 * Dispatch state. Kept apart from dd->lock so that dispatch attempts
+	 * that back off do not dirty the lock cacheline.
+	 */
+	unsigned long run_state;
+
 	struct dd_per_prio per_prio[DD_PRIO_COUNT];
 
 	/* Data direction of latest dispatched request. */
@@ -518,6 +527,17 @@ static struct request *dd_dispatch_request(struct blk_mq_hw_ctx *hctx)
 	struct request *rq;
 	enum dd_prio prio;
 
+	/*
+	 * If another CPU is already dispatching, there is nothing to gain from
+	 * queueing up behind it on dd->lock: whoever holds the bit will pull
+	 * whatever is dispatchable, and the queue is rerun on completions.
+	 * Backing off here is what keeps dd->lock from collapsing when many
+	 * hardware queues dispatch concurrently.
+	 */
+	if (test_bit(DD_DISPATCHING, &dd->run_state) ||
+	    test_and_set_bit_lock(DD_DISPATCHING, &dd->run_state))
+		return NULL;
+
 	spin_lock(&dd->lock);
 	rq = dd_dispatch_prio_aged_requests(dd, now);
 	if (rq)
@@ -535,6 +555,7 @@ static struct request *dd_dispatch_request(struct blk_mq_hw_ctx *hctx)
 
 unlock:
 	spin_unlock(&dd->lock);
+	clear_bit_unlock(DD_DISPATCHING, &dd->run_state);
 
 	return rq;
 }
@@ -696,7 +717,13 @@ static bool dd_bio_merge(struct request_queue *q, struct bio *bio,
 	struct request *free = NULL;
 	bool ret;
 
-	spin_lock(&dd->lock);
+	/*
+	 * A merge is just an optimization: if the lock is contended, not
+	 * merging is cheaper than waiting our turn behind inserters and
+	 * dispatchers just to (most likely) fail the lookup.
+	 */
+	if (!spin_trylock(&dd->lock))
+		return false;
 	ret = blk_mq_sched_try_merge(q, bio, nr_segs, &free);
 	spin_unlock(&dd->lock);
 
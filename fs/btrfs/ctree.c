@@ -1610,6 +1610,14 @@ static struct extent_buffer *btrfs_search_slot_get_root(struct btrfs_root *root,
 		/*
 		 * Ensure that all callers have set skip_locking when
 		 * p->search_commit_root = 1.
+		 *
+		 * Commit root searches never take extent buffer locks: the
+		 * commit root and everything below it is immutable for as
+		 * long as a transaction commit can't finish, which callers
+		 * ensure by holding either commit_root_sem (possibly via
+		 * p->need_commit_sem) or a transaction handle.  This is what
+		 * keeps read-mostly users like send and backref walking off
+		 * the tree lock cachelines entirely.
 		 */
 		ASSERT(p->skip_locking == 1);
 
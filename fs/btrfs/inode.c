@@ -2596,7 +2596,9 @@ out:
  *    c-2) if root is reloc root:	sync submit
  *         (only in case of buffered IO)
  *
- *    c-3) otherwise:			async submit
+ *    c-3) if the checksum implementation is fast:	sync submit
+ *
+ *    c-4) otherwise:			async submit
  */
 void btrfs_submit_data_bio(struct inode *inode, struct bio *bio,
 			   int mirror_num, enum btrfs_compression_type compress_type)
@@ -2606,7 +2608,13 @@ void btrfs_submit_data_bio(struct inode *inode, struct bio *bio,
 	enum btrfs_wq_endio_type metadata = BTRFS_WQ_ENDIO_DATA;
 	blk_status_t ret = 0;
 	int skip_sum;
-	int async = !atomic_read(&BTRFS_I(inode)->sync_writers);
+	/*
+	 * With a fast checksum implementation the workqueue bounce costs more
+	 * than checksumming inline in the submitter - same rule as metadata
+	 * writes in should_async_write().
+	 */
+	int async = !atomic_read(&BTRFS_I(inode)->sync_writers) &&
+		    !test_bit(BTRFS_FS_CSUM_IMPL_FAST, &fs_info->flags);
 
 	skip_sum = (BTRFS_I(inode)->flags & BTRFS_INODE_NODATASUM) ||
 		test_bit(BTRFS_FS_STATE_NO_CSUMS, &fs_info->fs_state);
@@ -7976,9 +7984,11 @@ static inline blk_status_t btrfs_submit_dio_bio(struct bio *bio,
 	bool write = btrfs_op(bio) == BTRFS_MAP_WRITE;
 	blk_status_t ret;
 
-	/* Check btrfs_submit_bio_hook() for rules about async submit. */
+	/* Check btrfs_submit_data_bio() for rules about async submit. */
 	if (async_submit)
-		async_submit = !atomic_read(&BTRFS_I(inode)->sync_writers);
+		async_submit = !atomic_read(&BTRFS_I(inode)->sync_writers) &&
+			       !test_bit(BTRFS_FS_CSUM_IMPL_FAST,
+					 &fs_info->flags);
 
 	if (!write) {
 		ret = btrfs_bio_wq_end_io(fs_info, bio, BTRFS_WQ_ENDIO_DATA);
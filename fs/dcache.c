@@ -128,6 +128,27 @@ static DEFINE_PER_CPU(long, nr_dentry);
 static DEFINE_PER_CPU(long, nr_dentry_unused);
 static DEFINE_PER_CPU(long, nr_dentry_negative);
 
+/*
+ * Cap on the number of negative dentries kept around; 0 means no limit.
+ * Once the cap is exceeded, dput() stops retaining negative dentries
+ * until the total drops below the cap again, so the excess is shed one
+ * dentry at a time by the tasks producing them rather than in large
+ * shrinker storms.
+ */
+static unsigned long negative_dentry_limit __read_mostly;
+static bool negative_dentry_shed;
+static DEFINE_PER_CPU(unsigned int, negative_dentry_scan);
+
+static long get_nr_dentry_negative(void)
+{
+	int i;
+	long sum = 0;
+
+	for_each_possible_cpu(i)
+		sum += per_cpu(nr_dentry_negative, i);
+	return sum < 0 ? 0 : sum;
+}
+
 #if defined(CONFIG_SYSCTL) && defined(CONFIG_PROC_FS)
 /* Statistics gathering. */
 static struct dentry_stat_t dentry_stat = {
@@ -164,16 +185,6 @@ static long get_nr_dentry_unused(void)
 	return sum < 0 ? 0 : sum;
 }
 
-static long get_nr_dentry_negative(void)
-{
-	int i;
-	long sum = 0;
-
-	for_each_possible_cpu(i)
-		sum += per_cpu(nr_dentry_negative, i);
-	return sum < 0 ? 0 : sum;
-}
-
 static int proc_nr_dentry(struct ctl_table *table, int write, void *buffer,
 			  size_t *lenp, loff_t *ppos)
 {
@@ -191,6 +202,13 @@ static struct ctl_table fs_dcache_sysctls[] = {
 		.mode		= 0444,
 		.proc_handler	= proc_nr_dentry,
 	},
+	{
+		.procname	= "negative-dentry-limit",
+		.data		= &negative_dentry_limit,
+		.maxlen		= sizeof(negative_dentry_limit),
+		.mode		= 0644,
+		.proc_handler	= proc_doulongvec_minmax,
+	},
 	{ }
 };
 
@@ -660,6 +678,34 @@ static inline struct dentry *lock_parent(struct dentry *dentry)
 	return __lock_parent(dentry);
 }
 
+#define NEGATIVE_DENTRY_SCAN_PERIOD	64
+
+/*
+ * Should a negative dentry being dropped be kept on the LRU?  Summing
+ * the per-cpu counters on every dput() would be too expensive, so the
+ * cap is re-evaluated only every NEGATIVE_DENTRY_SCAN_PERIOD negative
+ * dentry drops on this CPU and the result latched in
+ * negative_dentry_shed until the next scan.
+ */
+static bool retain_negative_dentry(void)
+{
+	unsigned long limit = READ_ONCE(negative_dentry_limit);
+
+	if (likely(!limit))
+		return true;
+
+	if (!(this_cpu_inc_return(negative_dentry_scan) %
+	      NEGATIVE_DENTRY_SCAN_PERIOD)) {
+		unsigned long count = get_nr_dentry_negative();
+
+		if (count > limit)
+			WRITE_ONCE(negative_dentry_shed, true);
+		else if (count < limit - limit / 16)
+			WRITE_ONCE(negative_dentry_shed, false);
+	}
+	return !READ_ONCE(negative_dentry_shed);
+}
+
 static inline bool retain_dentry(struct dentry *dentry)
 {
 	WARN_ON(d_in_lookup(dentry));
@@ -679,6 +725,9 @@ static inline bool retain_dentry(struct dentry *dentry)
 	if (unlikely(dentry->d_flags & DCACHE_DONTCACHE))
 		return false;
 
+	if (d_is_negative(dentry) && unlikely(!retain_negative_dentry()))
+		return false;
+
 	/* retain; LRU fodder */
 	dentry->d_lockref.count--;
 	if (unlikely(!(dentry->d_flags & DCACHE_LRU_LIST)))
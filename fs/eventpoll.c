@@ -1634,13 +1634,74 @@ static int ep_modify(struct eventpoll *ep, struct epitem *epi,
 	return 0;
 }
 
+/* events staged on the stack before one batched copy to userspace */
+#define EP_EVENTS_BATCH 16
+
+/*
+ * Copy a batch of staged events to userspace and update the corresponding
+ * items. The item state is only touched once its event has actually been
+ * copied out, so a faulting user buffer leaves undelivered items on the
+ * ready list: those are put back on @txlist and re-inserted by
+ * ep_done_scan(). Returns the number of events delivered.
+ */
+static int ep_send_events_batch(struct eventpoll *ep, struct list_head *txlist,
+				struct epoll_event __user *uevents,
+				const struct epoll_event *kevents,
+				struct epitem **kepis, int nr)
+{
+	int sent, i;
+
+#if defined(CONFIG_ARM) && defined(CONFIG_OABI_COMPAT)
+	/* ARM OABI has an incompatible layout and needs the per event helper */
+	for (sent = 0; sent < nr; sent++) {
+		if (!epoll_put_uevent(kevents[sent].events, kevents[sent].data,
+				      uevents + sent))
+			break;
+	}
+#else
+	unsigned long left;
+
+	left = copy_to_user(uevents, kevents, nr * sizeof(*kevents));
+	sent = nr - DIV_ROUND_UP(left, sizeof(*kevents));
+#endif
+
+	for (i = 0; i < sent; i++) {
+		struct epitem *epi = kepis[i];
+
+		if (epi->event.events & EPOLLONESHOT)
+			epi->event.events &= EP_PRIVATE_BITS;
+		else if (!(epi->event.events & EPOLLET)) {
+			/*
+			 * If this file has been added with Level
+			 * Trigger mode, we need to insert back inside
+			 * the ready list, so that the next call to
+			 * epoll_wait() will check again the events
+			 * availability. At this point, no one can insert
+			 * into ep->rdllist besides us. The epoll_ctl()
+			 * callers are locked out by
+			 * ep_scan_ready_list() holding "mtx" and the
+			 * poll callback will queue them in ep->ovflist.
+			 */
+			list_add_tail(&epi->rdllink, &ep->rdllist);
+			ep_pm_stay_awake(epi);
+		}
+	}
+	for (i = sent; i < nr; i++) {
+		list_add(&kepis[i]->rdllink, txlist);
+		ep_pm_stay_awake(kepis[i]);
+	}
+	return sent;
+}
+
 static int ep_send_events(struct eventpoll *ep,
 			  struct epoll_event __user *events, int maxevents)
 {
+	struct epoll_event kevents[EP_EVENTS_BATCH];
+	struct epitem *kepis[EP_EVENTS_BATCH];
 	struct epitem *epi, *tmp;
 	LIST_HEAD(txlist);
 	poll_table pt;
-	int res = 0;
+	int res = 0, nbatch = 0;
 
 	/*
 	 * Always short-circuit for fatal signals to allow threads to make a
@@ -1662,8 +1723,9 @@ static int ep_send_events(struct eventpoll *ep,
 	list_for_each_entry_safe(epi, tmp, &txlist, rdllink) {
 		struct wakeup_source *ws;
 		__poll_t revents;
+		int sent;
 
-		if (res >= maxevents)
+		if (res + nbatch >= maxevents)
 			break;
 
 		/*
@@ -1685,40 +1747,39 @@ static int ep_send_events(struct eventpoll *ep,
 		list_del_init(&epi->rdllink);
 
 		/*
-		 * If the event mask intersect the caller-requested one,
-		 * deliver the event to userspace. Again, we are holding ep->mtx,
-		 * so no operations coming from userspace can change the item.
+		 * If the event mask intersect the caller-requested one, stage
+		 * the event for delivery. Again, we are holding ep->mtx, so
+		 * no operations coming from userspace can change the item.
+		 * Staging events and writing them out one batch at a time
+		 * means one uaccess window per batch rather than per event.
 		 */
 		revents = ep_item_poll(epi, &pt, 1);
 		if (!revents)
 			continue;
 
-		events = epoll_put_uevent(revents, epi->event.data, events);
-		if (!events) {
-			list_add(&epi->rdllink, &txlist);
-			ep_pm_stay_awake(epi);
+		kevents[nbatch].events = revents;
+		kevents[nbatch].data = epi->event.data;
+		kepis[nbatch] = epi;
+		if (++nbatch < EP_EVENTS_BATCH)
+			continue;
+
+		sent = ep_send_events_batch(ep, &txlist, events + res,
+					    kevents, kepis, nbatch);
+		res += sent;
+		nbatch = 0;
+		if (sent < EP_EVENTS_BATCH) {
 			if (!res)
 				res = -EFAULT;
 			break;
 		}
-		res++;
-		if (epi->event.events & EPOLLONESHOT)
-			epi->event.events &= EP_PRIVATE_BITS;
-		else if (!(epi->event.events & EPOLLET)) {
-			/*
-			 * If this file has been added with Level
-			 * Trigger mode, we need to insert back inside
-			 * the ready list, so that the next call to
-			 * epoll_wait() will check again the events
-			 * availability. At this point, no one can insert
-			 * into ep->rdllist besides us. The epoll_ctl()
-			 * callers are locked out by
-			 * ep_scan_ready_list() holding "mtx" and the
-			 * poll callback will queue them in ep->ovflist.
-			 */
-			list_add_tail(&epi->rdllink, &ep->rdllist);
-			ep_pm_stay_awake(epi);
-		}
+	}
+	if (nbatch) {
+		int sent = ep_send_events_batch(ep, &txlist, events + res,
+						kevents, kepis, nbatch);
+
+		res += sent;
+		if (sent < nbatch && !res)
+			res = -EFAULT;
 	}
 	ep_done_scan(ep, &txlist);
 	mutex_unlock(&ep->mtx);
@@ -2104,6 +2104,20 @@ static long wb_check_background_flush(struct bdi_writeback *wb)
 			.reason		= WB_REASON_BACKGROUND,
 		};
 
+		/*
+		 * Ask the helper worker to drain b_io alongside us.  A
+		 * single flusher can run out of CPU before a fast device
+		 * (or a striped array behind one bdi) runs out of
+		 * bandwidth.  Inode exclusion is provided by I_SYNC and
+		 * the list manipulation by wb->list_lock, so two workers
+		 * can safely pull inodes from the same queue; the helper
+		 * stops on its own once @wb drops below the background
+		 * threshold.
+		 */
+		if (num_online_cpus() > 1 &&
+		    test_bit(WB_registered, &wb->state))
+			queue_work(bdi_wq, &wb->bg_work);
+
 		return wb_writeback(wb, &work);
 	}
 
@@ -2239,6 +2253,36 @@ void wb_workfn(struct work_struct *work)
 		wb_wakeup_delayed(wb);
 }
 
+/*
+ * Helper worker queued by wb_check_background_flush() when a single flusher
+ * cannot keep a fast device busy.  It runs the same background writeback
+ * loop as the main worker and terminates as soon as @wb is back under the
+ * background threshold, so it never outlives the burst that started it.
+ */
+void wb_bg_workfn(struct work_struct *work)
+{
+	struct bdi_writeback *wb = container_of(work, struct bdi_writeback,
+						bg_work);
+	struct wb_writeback_work bg_work = {
+		.nr_pages	= LONG_MAX,
+		.sync_mode	= WB_SYNC_NONE,
+		.for_background	= 1,
+		.range_cyclic	= 1,
+		.reason		= WB_REASON_BACKGROUND,
+	};
+	long pages_written;
+
+	set_worker_desc("flush-bg-%s", bdi_dev_name(wb->bdi));
+
+	/* Like wb_workfn(), don't hog the emergency worker */
+	if (unlikely(current_is_workqueue_rescuer()))
+		pages_written = writeback_inodes_wb(wb, 1024,
+						    WB_REASON_BACKGROUND);
+	else
+		pages_written = wb_writeback(wb, &bg_work);
+	trace_writeback_pages_written(pages_written);
+}
+
 /*
  * Start writeback of `nr_pages' pages on this bdi. If `nr_pages' is zero,
  * write back the whole world.
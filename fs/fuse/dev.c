@@ -210,9 +210,15 @@ static unsigned int fuse_req_hash(u64 unique)
 static void fuse_dev_wake_and_unlock(struct fuse_iqueue *fiq)
 __releases(fiq->lock)
 {
+	/*
+	 * Drop the lock before waking the reader, otherwise it wakes up
+	 * only to go back to sleep on fiq->lock.  The wakeup cannot get
+	 * lost: the request was queued under the lock and the reader
+	 * rechecks request_pending() under the lock before sleeping.
+	 */
+	spin_unlock(&fiq->lock);
 	wake_up(&fiq->waitq);
 	kill_fasync(&fiq->fasync, SIGIO, POLL_IN);
-	spin_unlock(&fiq->lock);
 }
 
 const struct fuse_iqueue_ops fuse_dev_fiq_ops = {
@@ -57,6 +57,7 @@
 #include <linux/mman.h>
 #include <linux/percpu.h>
 #include <linux/slab.h>
+#include <linux/vmalloc.h>
 #include <linux/blk-mq.h>
 #include <linux/bvec.h>
 #include <linux/net.h>
@@ -81,6 +82,7 @@
 #include <linux/audit.h>
 #include <linux/security.h>
 #include <linux/xattr.h>
+#include <linux/resource.h>
 
 #define CREATE_TRACE_POINTS
 #include <trace/events/io_uring.h>
@@ -280,7 +282,6 @@ struct io_rsrc_data {
 	bool				quiesce;
 };
 
-#define IO_BUFFER_LIST_BUF_PER_PAGE (PAGE_SIZE / sizeof(struct io_uring_buf))
 struct io_buffer_list {
 	/*
 	 * If ->buf_nr_pages is set, then buf_pages/buf_ring are used. If not,
@@ -339,6 +340,7 @@ struct io_sq_data {
 	pid_t			task_pid;
 	pid_t			task_tgid;
 
+	u64			work_time;
 	unsigned long		state;
 	struct completion	exited;
 };
@@ -501,6 +503,9 @@ struct io_ring_ctx {
 		struct llist_head		rsrc_put_llist;
 		struct list_head		rsrc_ref_list;
 		spinlock_t			rsrc_ref_lock;
+		/* retired nodes kept for reuse, under rsrc_ref_lock */
+		struct list_head		rsrc_node_cache;
+		unsigned int			rsrc_nr_cached;
 
 		struct list_head	io_buffers_pages;
 	};
@@ -668,6 +673,24 @@ struct io_sr_msg {
 	unsigned int			flags;
 };
 
+struct io_sendzc {
+	struct file			*file;
+	void __user			*buf;
+	size_t				len;
+	size_t				done_io;
+	unsigned			msg_flags;
+	unsigned			flags;
+	unsigned			addr_len;
+	void __user			*addr;
+	/* carries the zerocopy notification, posts a second CQE */
+	struct io_kiocb			*notif;
+};
+
+struct io_notif_data {
+	struct file			*file;
+	struct ubuf_info		uarg;
+};
+
 struct io_open {
 	struct file			*file;
 	int				dfd;
@@ -991,6 +1014,8 @@ struct io_kiocb {
 		struct io_xattr		xattr;
 		struct io_socket	sock;
 		struct io_uring_cmd	uring_cmd;
+		struct io_sendzc	msgzc;
+		struct io_notif_data	notif;
 	};
 
 	u8				opcode;
@@ -1333,6 +1358,13 @@ static const struct io_op_def io_op_defs[] = {
 		.needs_async_setup	= 1,
 		.async_size		= uring_cmd_pdu_size(1),
 	},
+	[IORING_OP_SEND_ZC] = {
+		.needs_file		= 1,
+		.unbound_nonreg_file	= 1,
+		.pollout		= 1,
+		.audit_skip		= 1,
+		.ioprio			= 1,	/* used for flags */
+	},
 };
 
 /* requests with any of those set should undergo io_disarm_next() */
@@ -1474,6 +1506,8 @@ const char *io_uring_get_opcode(u8 opcode)
 		return "SOCKET";
 	case IORING_OP_URING_CMD:
 		return "URING_CMD";
+	case IORING_OP_SEND_ZC:
+		return "SEND_ZC";
 	case IORING_OP_LAST:
 		return "INVALID";
 	}
@@ -1942,6 +1976,7 @@ static __cold struct io_ring_ctx *io_ring_ctx_alloc(struct io_uring_params *p)
 	INIT_LIST_HEAD(&ctx->ltimeout_list);
 	spin_lock_init(&ctx->rsrc_ref_lock);
 	INIT_LIST_HEAD(&ctx->rsrc_ref_list);
+	INIT_LIST_HEAD(&ctx->rsrc_node_cache);
 	INIT_DELAYED_WORK(&ctx->rsrc_put_work, io_rsrc_put_work);
 	init_llist_head(&ctx->rsrc_put_llist);
 	INIT_LIST_HEAD(&ctx->tctx_list);
@@ -3728,11 +3763,10 @@ static void kiocb_done(struct io_kiocb *req, ssize_t ret,
 	}
 }
 
-static int __io_import_fixed(struct io_kiocb *req, int rw, struct iov_iter *iter,
-			     struct io_mapped_ubuf *imu)
+static int __io_import_fixed(u64 buf_addr, size_t len, int rw,
+			     struct iov_iter *iter, struct io_mapped_ubuf *imu)
 {
-	size_t len = req->rw.len;
-	u64 buf_end, buf_addr = req->rw.addr;
+	u64 buf_end;
 	size_t offset;
 
 	if (unlikely(check_add_overflow(buf_addr, (u64)len, &buf_end)))
@@ -3791,9 +3825,20 @@ static int io_import_fixed(struct io_kiocb *req, int rw, struct iov_iter *iter,
 {
 	if (WARN_ON_ONCE(!req->imu))
 		return -EFAULT;
-	return __io_import_fixed(req, rw, iter, req->imu);
+	return __io_import_fixed(req->rw.addr, req->rw.len, rw, iter, req->imu);
 }
 
+int io_uring_cmd_import_fixed(u64 ubuf, unsigned long len, int rw,
+			      struct iov_iter *iter, void *ioucmd)
+{
+	struct io_kiocb *req = container_of(ioucmd, struct io_kiocb, uring_cmd);
+
+	if (WARN_ON_ONCE(!req->imu))
+		return -EFAULT;
+	return __io_import_fixed(ubuf, len, rw, iter, req->imu);
+}
+EXPORT_SYMBOL_GPL(io_uring_cmd_import_fixed);
+
 static int io_buffer_add_list(struct io_ring_ctx *ctx,
 			      struct io_buffer_list *bl, unsigned int bgid)
 {
@@ -3812,7 +3857,7 @@ static void __user *io_provided_buffer_select(struct io_kiocb *req, size_t *len,
 
 		kbuf = list_first_entry(&bl->buf_list, struct io_buffer, list);
 		list_del(&kbuf->list);
-		if (*len > kbuf->len)
+		if (*len == 0 || *len > kbuf->len)
 			*len = kbuf->len;
 		req->flags |= REQ_F_BUFFER_SELECTED;
 		req->kbuf = kbuf;
@@ -3834,15 +3879,8 @@ static void __user *io_ring_buffer_select(struct io_kiocb *req, size_t *len,
 		return NULL;
 
 	head &= bl->mask;
-	if (head < IO_BUFFER_LIST_BUF_PER_PAGE) {
-		buf = &br->bufs[head];
-	} else {
-		int off = head & (IO_BUFFER_LIST_BUF_PER_PAGE - 1);
-		int index = head / IO_BUFFER_LIST_BUF_PER_PAGE;
-		buf = page_address(bl->buf_pages[index]);
-		buf += off;
-	}
-	if (*len > buf->len)
+	buf = &br->bufs[head];
+	if (*len == 0 || *len > buf->len)
 		*len = buf->len;
 	req->flags |= REQ_F_BUFFER_RING;
 	req->buf_list = bl;
@@ -4261,7 +4299,7 @@ static inline int io_iter_do_read(struct io_kiocb *req, struct iov_iter *iter)
 		return -EINVAL;
 }
 
-static bool need_read_all(struct io_kiocb *req)
+static bool need_complete_io(struct io_kiocb *req)
 {
 	return req->flags & REQ_F_ISREG ||
 		S_ISBLK(file_inode(req->file)->i_mode);
@@ -4294,12 +4332,15 @@ static int io_rw_init_file(struct io_kiocb *req, fmode_t mode)
 	    ((file->f_flags & O_NONBLOCK) && !io_file_supports_nowait(req)))
 		req->flags |= REQ_F_NOWAIT;
 
+	/* the bio alloc cache accepts puts from IRQ completions as well */
+	kiocb->ki_flags |= IOCB_ALLOC_CACHE;
+
 	if (ctx->flags & IORING_SETUP_IOPOLL) {
 		if (!(kiocb->ki_flags & IOCB_DIRECT) || !file->f_op->iopoll)
 			return -EOPNOTSUPP;
 
 		kiocb->private = NULL;
-		kiocb->ki_flags |= IOCB_HIPRI | IOCB_ALLOC_CACHE;
+		kiocb->ki_flags |= IOCB_HIPRI;
 		kiocb->ki_complete = io_complete_rw_iopoll;
 		req->iopoll_completed = 0;
 	} else {
@@ -4391,7 +4432,7 @@ static int io_read(struct io_kiocb *req, unsigned int issue_flags)
 	} else if (ret == -EIOCBQUEUED) {
 		goto out_free;
 	} else if (ret == req->cqe.res || ret <= 0 || !force_nonblock ||
-		   (req->flags & REQ_F_NOWAIT) || !need_read_all(req)) {
+		   (req->flags & REQ_F_NOWAIT) || !need_complete_io(req)) {
 		/* read all, failed, already did sync or don't want to retry */
 		goto done;
 	}
@@ -4487,8 +4528,9 @@ static int io_write(struct io_kiocb *req, unsigned int issue_flags)
 		if (unlikely(!io_file_supports_nowait(req)))
 			goto copy_iov;
 
-		/* file path doesn't support NOWAIT for non-direct_IO */
-		if (force_nonblock && !(kiocb->ki_flags & IOCB_DIRECT) &&
+		/* File path supports async buffered writes */
+		if (!(kiocb->ki_flags & IOCB_DIRECT) &&
+		    !(req->file->f_mode & FMODE_BUF_WASYNC) &&
 		    (req->flags & REQ_F_ISREG))
 			goto copy_iov;
 
@@ -4543,6 +4585,25 @@ static int io_write(struct io_kiocb *req, unsigned int issue_flags)
 		/* IOPOLL retry should happen for io-wq threads */
 		if (ret2 == -EAGAIN && (req->ctx->flags & IORING_SETUP_IOPOLL))
 			goto copy_iov;
+
+		if (ret2 != req->cqe.res && ret2 >= 0 && need_complete_io(req)) {
+			struct io_async_rw *rw;
+
+			/*
+			 * This is a partial write. The file pos has already
+			 * been updated, setup the async struct to complete
+			 * the request in the worker. Also update bytes_done
+			 * to account for the bytes already written.
+			 */
+			iov_iter_save_state(&s->iter, &s->iter_state);
+			ret = io_setup_async_rw(req, iovec, s, true);
+
+			rw = req->async_data;
+			if (rw)
+				rw->bytes_done += ret2;
+
+			return ret ? ret : -EAGAIN;
+		}
 done:
 		kiocb_done(req, ret2, issue_flags);
 	} else {
@@ -5074,8 +5135,24 @@ static int io_uring_cmd_prep(struct io_kiocb *req,
 {
 	struct io_uring_cmd *ioucmd = &req->uring_cmd;
 
-	if (sqe->rw_flags || sqe->__pad1)
+	if (sqe->__pad1)
 		return -EINVAL;
+
+	ioucmd->flags = READ_ONCE(sqe->uring_cmd_flags);
+	if (ioucmd->flags & ~IORING_URING_CMD_FIXED)
+		return -EINVAL;
+
+	if (ioucmd->flags & IORING_URING_CMD_FIXED) {
+		struct io_ring_ctx *ctx = req->ctx;
+		u16 index;
+
+		req->buf_index = READ_ONCE(sqe->buf_index);
+		if (unlikely(req->buf_index >= ctx->nr_user_bufs))
+			return -EFAULT;
+		index = array_index_nospec(req->buf_index, ctx->nr_user_bufs);
+		req->imu = ctx->user_bufs[index];
+		io_req_set_rsrc_node(req, ctx, 0);
+	}
 	ioucmd->cmd = sqe->cmd;
 	ioucmd->cmd_op = READ_ONCE(sqe->cmd_op);
 	return 0;
@@ -5549,6 +5626,7 @@ static int __io_remove_buffers(struct io_ring_ctx *ctx,
 		int j;
 
 		i = bl->buf_ring->tail - bl->head;
+		vunmap(bl->buf_ring);
 		for (j = 0; j < bl->buf_nr_pages; j++)
 			unpin_user_page(bl->buf_pages[j]);
 		kvfree(bl->buf_pages);
@@ -6069,6 +6147,7 @@ static int io_sendmsg_copy_hdr(struct io_kiocb *req,
 			       struct io_async_msghdr *iomsg)
 {
 	iomsg->msg.msg_name = &iomsg->addr;
+	iomsg->msg.msg_ubuf = NULL;
 	iomsg->free_iov = iomsg->fast_iov;
 	return sendmsg_copy_msghdr(&iomsg->msg, req->sr_msg.umsg,
 				   req->sr_msg.msg_flags, &iomsg->free_iov);
@@ -6192,6 +6271,7 @@ static int io_send(struct io_kiocb *req, unsigned int issue_flags)
 	msg.msg_control = NULL;
 	msg.msg_controllen = 0;
 	msg.msg_namelen = 0;
+	msg.msg_ubuf = NULL;
 
 	flags = sr->msg_flags;
 	if (issue_flags & IO_URING_F_NONBLOCK)
@@ -6223,6 +6303,193 @@ static int io_send(struct io_kiocb *req, unsigned int issue_flags)
 	return 0;
 }
 
+static void __io_notif_complete_tw(struct io_kiocb *notif, bool *locked)
+{
+	struct io_notif_data *nd = &notif->notif;
+	struct io_ring_ctx *ctx = notif->ctx;
+
+	if (nd->uarg.mmp.user)
+		mm_unaccount_pinned_pages(&nd->uarg.mmp);
+
+	spin_lock(&ctx->completion_lock);
+	io_fill_cqe_aux(ctx, notif->cqe.user_data, 0, IORING_CQE_F_NOTIF);
+	io_commit_cqring(ctx);
+	spin_unlock(&ctx->completion_lock);
+	io_cqring_ev_posted(ctx);
+
+	io_free_req(notif);
+}
+
+static void io_uring_tx_zerocopy_callback(struct sk_buff *skb,
+					  struct ubuf_info *uarg,
+					  bool success)
+{
+	struct io_notif_data *nd = container_of(uarg, struct io_notif_data, uarg);
+	struct io_kiocb *notif = container_of(nd, struct io_kiocb, notif);
+
+	if (refcount_dec_and_test(&uarg->refcnt)) {
+		notif->io_task_work.func = __io_notif_complete_tw;
+		io_req_task_work_add(notif);
+	}
+}
+
+static void io_notif_flush(struct io_kiocb *notif)
+{
+	struct io_notif_data *nd = &notif->notif;
+
+	/* drop the io_uring side reference */
+	if (refcount_dec_and_test(&nd->uarg.refcnt)) {
+		notif->io_task_work.func = __io_notif_complete_tw;
+		io_req_task_work_add(notif);
+	}
+}
+
+static struct io_kiocb *io_alloc_notif(struct io_ring_ctx *ctx)
+	__must_hold(&ctx->uring_lock)
+{
+	struct io_kiocb *notif;
+	struct io_notif_data *nd;
+
+	if (unlikely(!io_alloc_req_refill(ctx)))
+		return NULL;
+	notif = io_alloc_req(ctx);
+	notif->opcode = IORING_OP_NOP;
+	notif->flags = 0;
+	notif->file = NULL;
+	notif->rsrc_node = NULL;
+	notif->task = current;
+	io_get_task_refs(1);
+
+	nd = &notif->notif;
+	nd->uarg.flags = SKBFL_ZEROCOPY_FRAG;
+	nd->uarg.callback = io_uring_tx_zerocopy_callback;
+	nd->uarg.mmp.user = NULL;
+	nd->uarg.mmp.num_pg = 0;
+	refcount_set(&nd->uarg.refcnt, 1);
+	return notif;
+}
+
+static int io_sendzc_prep(struct io_kiocb *req, const struct io_uring_sqe *sqe)
+{
+	struct io_sendzc *zc = &req->msgzc;
+	struct io_kiocb *notif;
+
+	if (unlikely(READ_ONCE(sqe->__pad2[0]) || READ_ONCE(sqe->addr3)))
+		return -EINVAL;
+	/* the notification CQE can't be skipped */
+	if (req->flags & REQ_F_CQE_SKIP)
+		return -EINVAL;
+
+	zc->flags = READ_ONCE(sqe->ioprio);
+	if (zc->flags & ~IORING_RECVSEND_POLL_FIRST)
+		return -EINVAL;
+
+	zc->buf = u64_to_user_ptr(READ_ONCE(sqe->addr));
+	zc->len = READ_ONCE(sqe->len);
+	zc->msg_flags = READ_ONCE(sqe->msg_flags) | MSG_NOSIGNAL | MSG_ZEROCOPY;
+	if (zc->msg_flags & MSG_DONTWAIT)
+		req->flags |= REQ_F_NOWAIT;
+	zc->addr = u64_to_user_ptr(READ_ONCE(sqe->addr2));
+	zc->addr_len = READ_ONCE(sqe->addr_len);
+	zc->done_io = 0;
+
+#ifdef CONFIG_COMPAT
+	if (req->ctx->compat)
+		zc->msg_flags |= MSG_CMSG_COMPAT;
+#endif
+	notif = io_alloc_notif(req->ctx);
+	if (!notif)
+		return -ENOMEM;
+	notif->cqe.user_data = req->cqe.user_data;
+	zc->notif = notif;
+	req->flags |= REQ_F_NEED_CLEANUP;
+	return 0;
+}
+
+static int io_sendzc(struct io_kiocb *req, unsigned int issue_flags)
+{
+	struct sockaddr_storage address;
+	struct io_sendzc *zc = &req->msgzc;
+	struct io_notif_data *nd = &zc->notif->notif;
+	struct io_kiocb *notif;
+	struct msghdr msg;
+	struct iovec iov;
+	struct socket *sock;
+	unsigned msg_flags;
+	int ret, min_ret = 0;
+	bool force_nonblock = issue_flags & IO_URING_F_NONBLOCK;
+
+	if (!(req->flags & REQ_F_POLLED) &&
+	    (zc->flags & IORING_RECVSEND_POLL_FIRST))
+		return -EAGAIN;
+
+	sock = sock_from_file(req->file);
+	if (unlikely(!sock))
+		return -ENOTSOCK;
+
+	msg.msg_name = NULL;
+	msg.msg_control = NULL;
+	msg.msg_controllen = 0;
+	msg.msg_namelen = 0;
+
+	if (zc->addr) {
+		ret = move_addr_to_kernel(zc->addr, zc->addr_len, &address);
+		if (unlikely(ret < 0))
+			return ret;
+		msg.msg_name = (struct sockaddr *)&address;
+		msg.msg_namelen = zc->addr_len;
+	}
+
+	ret = import_single_range(WRITE, zc->buf, zc->len, &iov, &msg.msg_iter);
+	if (unlikely(ret))
+		return ret;
+
+	if (mm_account_pinned_pages(&nd->uarg.mmp, zc->len))
+		return -ENOMEM;
+
+	msg_flags = zc->msg_flags;
+	if (force_nonblock)
+		msg_flags |= MSG_DONTWAIT;
+	if (msg_flags & MSG_WAITALL)
+		min_ret = iov_iter_count(&msg.msg_iter);
+
+	msg.msg_flags = msg_flags;
+	msg.msg_ubuf = &nd->uarg;
+	ret = sock_sendmsg(sock, &msg);
+
+	if (unlikely(ret < min_ret)) {
+		if (ret == -EAGAIN && force_nonblock)
+			return -EAGAIN;
+		if (ret == -ERESTARTSYS)
+			ret = -EINTR;
+		if (ret > 0 && io_net_retry(sock, msg.msg_flags)) {
+			zc->len -= ret;
+			zc->buf += ret;
+			zc->done_io += ret;
+			req->flags |= REQ_F_PARTIAL_IO;
+			return -EAGAIN;
+		}
+		req_set_fail(req);
+	}
+
+	if (ret >= 0)
+		ret += zc->done_io;
+	else if (zc->done_io)
+		ret = zc->done_io;
+
+	notif = zc->notif;
+	zc->notif = NULL;
+	req->flags &= ~REQ_F_NEED_CLEANUP;
+	/*
+	 * The notification CQE is only posted once the network side has
+	 * dropped its references to the buffer, so it must go out after
+	 * the main completion.
+	 */
+	__io_req_complete(req, issue_flags, ret, IORING_CQE_F_MORE);
+	io_notif_flush(notif);
+	return 0;
+}
+
 static int __io_recvmsg_copy_hdr(struct io_kiocb *req,
 				 struct io_async_msghdr *iomsg)
 {
@@ -6330,11 +6597,25 @@ static int io_recvmsg_prep(struct io_kiocb *req, const struct io_uring_sqe *sqe)
 	sr->umsg = u64_to_user_ptr(READ_ONCE(sqe->addr));
 	sr->len = READ_ONCE(sqe->len);
 	sr->flags = READ_ONCE(sqe->ioprio);
-	if (sr->flags & ~IORING_RECVSEND_POLL_FIRST)
+	if (sr->flags & ~(IORING_RECVSEND_POLL_FIRST | IORING_RECV_MULTISHOT))
 		return -EINVAL;
 	sr->msg_flags = READ_ONCE(sqe->msg_flags) | MSG_NOSIGNAL;
 	if (sr->msg_flags & MSG_DONTWAIT)
 		req->flags |= REQ_F_NOWAIT;
+	if (sr->flags & IORING_RECV_MULTISHOT) {
+		/*
+		 * Multishot needs a provided buffer per receive, and the
+		 * length comes from the selected buffer. MSG_WAITALL makes
+		 * no sense when each CQE stands on its own.
+		 */
+		if (!(req->flags & REQ_F_BUFFER_SELECT))
+			return -EINVAL;
+		if (sr->msg_flags & MSG_WAITALL)
+			return -EINVAL;
+		if (req->opcode != IORING_OP_RECV || sr->len)
+			return -EINVAL;
+		req->flags |= REQ_F_APOLL_MULTISHOT;
+	}
 
 #ifdef CONFIG_COMPAT
 	if (req->ctx->compat)
@@ -6344,6 +6625,40 @@ static int io_recvmsg_prep(struct io_kiocb *req, const struct io_uring_sqe *sqe)
 	return 0;
 }
 
+/*
+ * Finishes io_recv and io_recvmsg.
+ *
+ * Returns true if it is actually finished, or false if it should run
+ * again (for multishot CQEs).
+ */
+static bool io_recv_finish(struct io_kiocb *req, int *ret, unsigned int cflags,
+			   unsigned int issue_flags)
+{
+	struct io_ring_ctx *ctx = req->ctx;
+	bool filled;
+
+	if (!(req->flags & REQ_F_APOLL_MULTISHOT)) {
+		__io_req_complete(req, issue_flags, *ret, cflags);
+		*ret = 0;
+		return true;
+	}
+
+	if (*ret > 0) {
+		spin_lock(&ctx->completion_lock);
+		filled = io_fill_cqe_aux(ctx, req->cqe.user_data, *ret,
+					 cflags | IORING_CQE_F_MORE);
+		io_commit_cqring(ctx);
+		spin_unlock(&ctx->completion_lock);
+		if (filled) {
+			io_cqring_ev_posted(ctx);
+			*ret = 0;
+			return false;
+		}
+		*ret = -ECANCELED;
+	}
+	return true;
+}
+
 static int io_recvmsg(struct io_kiocb *req, unsigned int issue_flags)
 {
 	struct io_async_msghdr iomsg, *kmsg;
@@ -6417,8 +6732,8 @@ static int io_recvmsg(struct io_kiocb *req, unsigned int issue_flags)
 	cflags = io_put_kbuf(req, issue_flags);
 	if (kmsg->msg.msg_inq)
 		cflags |= IORING_CQE_F_SOCK_NONEMPTY;
-	__io_req_complete(req, issue_flags, ret, cflags);
-	return 0;
+	io_recv_finish(req, &ret, cflags, issue_flags);
+	return ret;
 }
 
 static int io_recv(struct io_kiocb *req, unsigned int issue_flags)
@@ -6431,6 +6746,7 @@ static int io_recv(struct io_kiocb *req, unsigned int issue_flags)
 	unsigned flags;
 	int ret, min_ret = 0;
 	bool force_nonblock = issue_flags & IO_URING_F_NONBLOCK;
+	size_t len;
 
 	if (!(req->flags & REQ_F_POLLED) &&
 	    (sr->flags & IORING_RECVSEND_POLL_FIRST))
@@ -6440,16 +6756,18 @@ static int io_recv(struct io_kiocb *req, unsigned int issue_flags)
 	if (unlikely(!sock))
 		return -ENOTSOCK;
 
+retry_multishot:
+	len = sr->len;
 	if (io_do_buffer_select(req)) {
 		void __user *buf;
 
-		buf = io_buffer_select(req, &sr->len, issue_flags);
+		buf = io_buffer_select(req, &len, issue_flags);
 		if (!buf)
 			return -ENOBUFS;
 		sr->buf = buf;
 	}
 
-	ret = import_single_range(READ, sr->buf, sr->len, &iov, &msg.msg_iter);
+	ret = import_single_range(READ, sr->buf, len, &iov, &msg.msg_iter);
 	if (unlikely(ret))
 		goto out_free;
 
@@ -6469,8 +6787,14 @@ static int io_recv(struct io_kiocb *req, unsigned int issue_flags)
 
 	ret = sock_recvmsg(sock, &msg, flags);
 	if (ret < min_ret) {
-		if (ret == -EAGAIN && force_nonblock)
+		if (ret == -EAGAIN && force_nonblock) {
+			if ((req->flags & IO_APOLL_MULTI_POLLED) ==
+			    IO_APOLL_MULTI_POLLED) {
+				io_kbuf_recycle(req, issue_flags);
+				return 0;
+			}
 			return -EAGAIN;
+		}
 		if (ret == -ERESTARTSYS)
 			ret = -EINTR;
 		if (ret > 0 && io_net_retry(sock, flags)) {
@@ -6493,8 +6817,10 @@ out_free:
 	cflags = io_put_kbuf(req, issue_flags);
 	if (msg.msg_inq)
 		cflags |= IORING_CQE_F_SOCK_NONEMPTY;
-	__io_req_complete(req, issue_flags, ret, cflags);
-	return 0;
+	if (!io_recv_finish(req, &ret, cflags, issue_flags))
+		goto retry_multishot;
+
+	return ret;
 }
 
 static int io_accept_prep(struct io_kiocb *req, const struct io_uring_sqe *sqe)
@@ -6737,8 +7063,13 @@ IO_NETOP_PREP_ASYNC(connect);
 IO_NETOP_PREP(accept);
 IO_NETOP_PREP(socket);
 IO_NETOP_PREP(shutdown);
+IO_NETOP_PREP(sendzc);
 IO_NETOP_FN(send);
 IO_NETOP_FN(recv);
+
+static void io_notif_flush(struct io_kiocb *notif)
+{
+}
 #endif /* CONFIG_NET */
 
 struct io_poll_table {
@@ -8129,6 +8460,8 @@ static int io_req_prep(struct io_kiocb *req, const struct io_uring_sqe *sqe)
 		return io_socket_prep(req, sqe);
 	case IORING_OP_URING_CMD:
 		return io_uring_cmd_prep(req, sqe);
+	case IORING_OP_SEND_ZC:
+		return io_sendzc_prep(req, sqe);
 	}
 
 	printk_once(KERN_WARNING "io_uring: unhandled opcode %d\n",
@@ -8253,6 +8586,12 @@ static void io_clean_op(struct io_kiocb *req)
 			kfree(io->free_iov);
 			break;
 			}
+		case IORING_OP_SEND_ZC:
+			if (req->msgzc.notif) {
+				io_notif_flush(req->msgzc.notif);
+				req->msgzc.notif = NULL;
+			}
+			break;
 		case IORING_OP_OPENAT:
 		case IORING_OP_OPENAT2:
 			if (req->open.filename)
@@ -8466,6 +8805,9 @@ static int io_issue_sqe(struct io_kiocb *req, unsigned int issue_flags)
 	case IORING_OP_URING_CMD:
 		ret = io_uring_cmd(req, issue_flags);
 		break;
+	case IORING_OP_SEND_ZC:
+		ret = io_sendzc(req, issue_flags);
+		break;
 	default:
 		ret = -EINVAL;
 		break;
@@ -9191,10 +9533,22 @@ static bool io_sqd_handle_event(struct io_sq_data *sqd)
 	return did_sig || test_bit(IO_SQ_THREAD_SHOULD_STOP, &sqd->state);
 }
 
+static void io_sq_update_worktime(struct io_sq_data *sqd, struct rusage *start)
+{
+	struct rusage end;
+
+	getrusage(current, RUSAGE_SELF, &end);
+	end.ru_stime.tv_sec -= start->ru_stime.tv_sec;
+	end.ru_stime.tv_usec -= start->ru_stime.tv_usec;
+
+	sqd->work_time += end.ru_stime.tv_usec + end.ru_stime.tv_sec * 1000000;
+}
+
 static int io_sq_thread(void *data)
 {
 	struct io_sq_data *sqd = data;
 	struct io_ring_ctx *ctx;
+	struct rusage start;
 	unsigned long timeout = 0;
 	char buf[TASK_COMM_LEN];
 	DEFINE_WAIT(wait);
@@ -9221,6 +9575,7 @@ static int io_sq_thread(void *data)
 		}
 
 		cap_entries = !list_is_singular(&sqd->ctx_list);
+		getrusage(current, RUSAGE_SELF, &start);
 		list_for_each_entry(ctx, &sqd->ctx_list, sqd_list) {
 			int ret = __io_sq_thread(ctx, cap_entries);
 
@@ -9232,8 +9587,10 @@ static int io_sq_thread(void *data)
 
 		if (sqt_spin || !time_after(jiffies, timeout)) {
 			cond_resched();
-			if (sqt_spin)
+			if (sqt_spin) {
+				io_sq_update_worktime(sqd, &start);
 				timeout = jiffies + sqd->sq_thread_idle;
+			}
 			continue;
 		}
 
@@ -9459,12 +9816,35 @@ static __cold void **io_alloc_page_table(size_t size)
 	return table;
 }
 
+/*
+ * Retired nodes are kept around for reuse: at fixed file update rates of
+ * tens of thousands per second, allocating and percpu_ref_init()'ing a
+ * fresh node per update batch shows up in profiles.
+ */
+#define IO_RSRC_NODE_CACHE_MAX	64
+
 static void io_rsrc_node_destroy(struct io_rsrc_node *ref_node)
 {
 	percpu_ref_exit(&ref_node->refs);
 	kfree(ref_node);
 }
 
+static void io_rsrc_node_cache_put(struct io_ring_ctx *ctx,
+				   struct io_rsrc_node *ref_node)
+{
+	unsigned long flags;
+
+	spin_lock_irqsave(&ctx->rsrc_ref_lock, flags);
+	if (ctx->rsrc_nr_cached < IO_RSRC_NODE_CACHE_MAX) {
+		list_add(&ref_node->node, &ctx->rsrc_node_cache);
+		ctx->rsrc_nr_cached++;
+		ref_node = NULL;
+	}
+	spin_unlock_irqrestore(&ctx->rsrc_ref_lock, flags);
+	if (ref_node)
+		io_rsrc_node_destroy(ref_node);
+}
+
 static __cold void io_rsrc_node_ref_zero(struct percpu_ref *ref)
 {
 	struct io_rsrc_node *node = container_of(ref, struct io_rsrc_node, refs);
@@ -9495,10 +9875,27 @@ static __cold void io_rsrc_node_ref_zero(struct percpu_ref *ref)
 		mod_delayed_work(system_wq, &ctx->rsrc_put_work, delay);
 }
 
-static struct io_rsrc_node *io_rsrc_node_alloc(void)
+static struct io_rsrc_node *io_rsrc_node_alloc(struct io_ring_ctx *ctx)
 {
 	struct io_rsrc_node *ref_node;
 
+	spin_lock_irq(&ctx->rsrc_ref_lock);
+	if (!list_empty(&ctx->rsrc_node_cache)) {
+		ref_node = list_first_entry(&ctx->rsrc_node_cache,
+					    struct io_rsrc_node, node);
+		list_del(&ref_node->node);
+		ctx->rsrc_nr_cached--;
+		spin_unlock_irq(&ctx->rsrc_ref_lock);
+
+		/* the cached node is dead and drained, revive it */
+		percpu_ref_reinit(&ref_node->refs);
+		INIT_LIST_HEAD(&ref_node->node);
+		INIT_LIST_HEAD(&ref_node->rsrc_list);
+		ref_node->done = false;
+		return ref_node;
+	}
+	spin_unlock_irq(&ctx->rsrc_ref_lock);
+
 	ref_node = kzalloc(sizeof(*ref_node), GFP_KERNEL);
 	if (!ref_node)
 		return NULL;
@@ -9546,7 +9943,7 @@ static int io_rsrc_node_switch_start(struct io_ring_ctx *ctx)
 {
 	if (ctx->rsrc_backup_node)
 		return 0;
-	ctx->rsrc_backup_node = io_rsrc_node_alloc();
+	ctx->rsrc_backup_node = io_rsrc_node_alloc(ctx);
 	return ctx->rsrc_backup_node ? 0 : -ENOMEM;
 }
 
@@ -10025,7 +10422,7 @@ static void __io_rsrc_put_work(struct io_rsrc_node *ref_node)
 		kfree(prsrc);
 	}
 
-	io_rsrc_node_destroy(ref_node);
+	io_rsrc_node_cache_put(ctx, ref_node);
 	if (atomic_dec_and_test(&rsrc_data->refs))
 		complete(&rsrc_data->done);
 }
@@ -10430,6 +10827,7 @@ static __cold int io_sq_offload_create(struct io_ring_ctx *ctx,
 	if (ctx->flags & IORING_SETUP_SQPOLL) {
 		struct task_struct *tsk;
 		struct io_sq_data *sqd;
+		int node = NUMA_NO_NODE;
 		bool attached;
 
 		ret = security_uring_sqpoll();
@@ -10467,13 +10865,18 @@ static __cold int io_sq_offload_create(struct io_ring_ctx *ctx,
 			if (cpu >= nr_cpu_ids || !cpu_online(cpu))
 				goto err_sqpoll;
 			sqd->sq_cpu = cpu;
+			/*
+			 * If the poller is pinned, keep its task_struct on the
+			 * same node so the submission hot path stays local.
+			 */
+			node = cpu_to_node(cpu);
 		} else {
 			sqd->sq_cpu = -1;
 		}
 
 		sqd->task_pid = current->pid;
 		sqd->task_tgid = current->tgid;
-		tsk = create_io_thread(io_sq_thread, sqd, NUMA_NO_NODE);
+		tsk = create_io_thread(io_sq_thread, sqd, node);
 		if (IS_ERR(tsk)) {
 			ret = PTR_ERR(tsk);
 			goto err_sqpoll;
@@ -11174,6 +11577,14 @@ static __cold void io_ring_ctx_free(struct io_ring_ctx *ctx)
 	if (ctx->rsrc_backup_node)
 		io_rsrc_node_destroy(ctx->rsrc_backup_node);
 	flush_delayed_work(&ctx->rsrc_put_work);
+	while (!list_empty(&ctx->rsrc_node_cache)) {
+		struct io_rsrc_node *node;
+
+		node = list_first_entry(&ctx->rsrc_node_cache,
+					struct io_rsrc_node, node);
+		list_del(&node->node);
+		io_rsrc_node_destroy(node);
+	}
 	flush_delayed_work(&ctx->fallback_work);
 
 	WARN_ON_ONCE(!list_empty(&ctx->rsrc_ref_list));
@@ -12155,6 +12566,8 @@ static __cold void __io_uring_show_fdinfo(struct io_ring_ctx *ctx,
 	unsigned int cq_tail = READ_ONCE(r->cq.tail);
 	unsigned int cq_shift = 0;
 	unsigned int sq_entries, cq_entries;
+	struct rusage sq_usage;
+	u64 sq_total_time = 0, sq_work_time = 0;
 	bool has_lock;
 	bool is_cqe32 = (ctx->flags & IORING_SETUP_CQE32);
 	unsigned int i;
@@ -12218,12 +12631,25 @@ static __cold void __io_uring_show_fdinfo(struct io_ring_ctx *ctx,
 
 	if (has_lock && (ctx->flags & IORING_SETUP_SQPOLL)) {
 		sq = ctx->sq_data;
-		if (!sq->thread)
+		if (!sq->thread) {
 			sq = NULL;
+		} else {
+			/*
+			 * sq->thread might be stale when we race with the
+			 * thread exiting, but the worst that gives us is a
+			 * bogus time sample.
+			 */
+			getrusage(sq->thread, RUSAGE_SELF, &sq_usage);
+			sq_total_time = (u64)sq_usage.ru_stime.tv_sec * 1000000 +
+					sq_usage.ru_stime.tv_usec;
+			sq_work_time = sq->work_time;
+		}
 	}
 
 	seq_printf(m, "SqThread:\t%d\n", sq ? task_pid_nr(sq->thread) : -1);
 	seq_printf(m, "SqThreadCpu:\t%d\n", sq ? task_cpu(sq->thread) : -1);
+	seq_printf(m, "SqTotalTime:\t%llu\n", sq_total_time);
+	seq_printf(m, "SqWorkTime:\t%llu\n", sq_work_time);
 	seq_printf(m, "UserFiles:\t%u\n", ctx->nr_user_files);
 	for (i = 0; has_lock && i < ctx->nr_user_files; i++) {
 		struct file *f = io_file_from_index(ctx, i);
@@ -12984,7 +13410,20 @@ static int io_register_pbuf_ring(struct io_ring_ctx *ctx, void __user *arg)
 		return PTR_ERR(pages);
 	}
 
-	br = page_address(pages[0]);
+	/*
+	 * Map the whole ring contiguously so that buffer lookups don't need
+	 * to care about page boundaries.
+	 */
+	br = vmap(pages, nr_pages, VM_MAP, PAGE_KERNEL);
+	if (!br) {
+		int i;
+
+		for (i = 0; i < nr_pages; i++)
+			unpin_user_page(pages[i]);
+		kvfree(pages);
+		kfree(free_bl);
+		return -ENOMEM;
+	}
 	bl->buf_pages = pages;
 	bl->buf_nr_pages = nr_pages;
 	bl->nr_entries = reg.ring_entries;
@@ -3387,6 +3387,39 @@ out_dput:
 	return ERR_PTR(error);
 }
 
+static struct dentry *lookup_fast_for_open(struct nameidata *nd, int open_flag,
+					   struct inode **inode, unsigned *seqp)
+{
+	struct dentry *dentry;
+
+	/*
+	 * An O_EXCL open has to take i_rwsem to reliably tell creating the
+	 * file apart from opening an existing one - don't bother looking.
+	 */
+	if ((open_flag & (O_CREAT | O_EXCL)) == (O_CREAT | O_EXCL))
+		return NULL;
+
+	dentry = lookup_fast(nd, inode, seqp);
+	if (IS_ERR_OR_NULL(dentry))
+		return dentry;
+
+	if (open_flag & O_CREAT) {
+		/*
+		 * A negative dentry is useless here - creation needs the
+		 * parent locked.  In RCU mode we hold no reference, so just
+		 * let the caller unlazy and redo the lookup under i_rwsem.
+		 */
+		if (nd->flags & LOOKUP_RCU) {
+			if (!*inode)
+				dentry = NULL;
+		} else if (d_is_negative(dentry)) {
+			dput(dentry);
+			dentry = NULL;
+		}
+	}
+	return dentry;
+}
+
 static const char *open_last_lookups(struct nameidata *nd,
 		   struct file *file, const struct open_flags *op)
 {
@@ -3409,13 +3442,24 @@ static const char *open_last_lookups(struct nameidata *nd,
 	if (!(open_flag & O_CREAT)) {
 		if (nd->last.name[nd->last.len])
 			nd->flags |= LOOKUP_FOLLOW | LOOKUP_DIRECTORY;
-		/* we _can_ be in RCU mode here */
-		dentry = lookup_fast(nd, &inode, &seq);
-		if (IS_ERR(dentry))
-			return ERR_CAST(dentry);
-		if (likely(dentry))
-			goto finish_lookup;
+	} else {
+		/* trailing slashes? */
+		if (unlikely(nd->last.name[nd->last.len]))
+			return ERR_PTR(-EISDIR);
+	}
 
+	/*
+	 * We _can_ be in RCU mode here.  Opening an existing file does not
+	 * need the parent locked even with O_CREAT, so try a lockless lookup
+	 * first; only creation (and O_EXCL) has to take i_rwsem.
+	 */
+	dentry = lookup_fast_for_open(nd, open_flag, &inode, &seq);
+	if (IS_ERR(dentry))
+		return ERR_CAST(dentry);
+	if (likely(dentry))
+		goto finish_lookup;
+
+	if (!(open_flag & O_CREAT)) {
 		BUG_ON(nd->flags & LOOKUP_RCU);
 	} else {
 		/* create side of things */
@@ -3424,9 +3468,6 @@ static const char *open_last_lookups(struct nameidata *nd,
 				return ERR_PTR(-ECHILD);
 		}
 		audit_inode(nd->name, dir, AUDIT_INODE_PARENT);
-		/* trailing slashes? */
-		if (unlikely(nd->last.name[nd->last.len]))
-			return ERR_PTR(-EISDIR);
 	}
 
 	if (open_flag & (O_CREAT | O_TRUNC | O_WRONLY | O_RDWR)) {
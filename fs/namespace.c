@@ -4403,16 +4403,23 @@ void __init mnt_init(void)
 	mnt_cache = kmem_cache_create("mnt_cache", sizeof(struct mount),
 			0, SLAB_HWCACHE_ALIGN|SLAB_PANIC|SLAB_ACCOUNT, NULL);
 
+	/*
+	 * The memory-scaled default only yields a few thousand buckets on
+	 * smaller machines, while container hosts easily run tens of
+	 * thousands of mounts regardless of RAM size.  Impose a floor so
+	 * hash chains walked by __lookup_mnt() stay short either way; 16k
+	 * head pointers cost 128K, which is noise.
+	 */
 	mount_hashtable = alloc_large_system_hash("Mount-cache",
 				sizeof(struct hlist_head),
 				mhash_entries, 19,
 				HASH_ZERO,
-				&m_hash_shift, &m_hash_mask, 0, 0);
+				&m_hash_shift, &m_hash_mask, 1UL << 14, 0);
 	mountpoint_hashtable = alloc_large_system_hash("Mountpoint-cache",
 				sizeof(struct hlist_head),
 				mphash_entries, 19,
 				HASH_ZERO,
-				&mp_hash_shift, &mp_hash_mask, 0, 0);
+				&mp_hash_shift, &mp_hash_mask, 1UL << 14, 0);
 
 	if (!mount_hashtable || !mountpoint_hashtable)
 		panic("Failed to allocate mount hash table\n");
@@ -71,6 +71,15 @@ nfsd_file_schedule_laundrette(void)
 	if (count == 0 || test_bit(NFSD_FILE_SHUTDOWN, &nfsd_file_lru_flags))
 		return;
 
+	/*
+	 * The laundrette worker reschedules itself for as long as there
+	 * are files in the cache, so puts only need to kick it when it is
+	 * idle.  Testing the pending bit first keeps every nfsd thread
+	 * from dirtying the shared work struct on each cached operation.
+	 */
+	if (delayed_work_pending(&nfsd_filecache_laundrette))
+		return;
+
 	queue_delayed_work(system_wq, &nfsd_filecache_laundrette,
 			NFSD_LAUNDRETTE_DELAY);
 }
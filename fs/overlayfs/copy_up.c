@@ -1090,6 +1090,17 @@ int ovl_copy_up_with_data(struct dentry *dentry)
 	return ovl_copy_up_flags(dentry, O_WRONLY);
 }
 
+/*
+ * Copy up for truncate to zero size.  The lower data is about to be
+ * discarded, so copy up only the metadata, same as open(O_TRUNC) does.
+ * O_TRUNC also makes ovl_copy_up_one() create the upper file without the
+ * metacopy xattr, since there is no lower data left to refer to.
+ */
+int ovl_copy_up_truncate(struct dentry *dentry)
+{
+	return ovl_copy_up_flags(dentry, O_WRONLY | O_TRUNC);
+}
+
 int ovl_copy_up(struct dentry *dentry)
 {
 	return ovl_copy_up_flags(dentry, 0);
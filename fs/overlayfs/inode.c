@@ -41,6 +41,8 @@ int ovl_setattr(struct user_namespace *mnt_userns, struct dentry *dentry,
 
 	if (!full_copy_up)
 		err = ovl_copy_up(dentry);
+	else if (!attr->ia_size)
+		err = ovl_copy_up_truncate(dentry);
 	else
 		err = ovl_copy_up_with_data(dentry);
 	if (!err) {
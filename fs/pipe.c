@@ -505,17 +505,15 @@ pipe_write(struct kiocb *iocb, struct iov_iter *from)
 			 * empty buffer.  If we fault or otherwise fail to use
 			 * it, either the reader will consume it or it'll still
 			 * be there for the next write.
+			 *
+			 * The only lockless head update is notification
+			 * posting, which was rejected with -EXDEV above and
+			 * can only be enabled at pipe creation.  Ordinary
+			 * pipes serialize the ring through pipe->mutex, the
+			 * same way splice_to_pipe() relies on it, so no
+			 * rd_wait.lock is needed here.
 			 */
-			spin_lock_irq(&pipe->rd_wait.lock);
-
-			head = pipe->head;
-			if (pipe_full(head, pipe->tail, pipe->max_usage)) {
-				spin_unlock_irq(&pipe->rd_wait.lock);
-				continue;
-			}
-
 			pipe->head = head + 1;
-			spin_unlock_irq(&pipe->rd_wait.lock);
 
 			/* Insert it into the buffer array */
 			buf = &pipe->bufs[head & mask];
@@ -837,6 +837,16 @@ ssize_t splice_direct_to_actor(struct file *in, struct splice_desc *sd,
 		if (!pipe)
 			return -ENOMEM;
 
+		/*
+		 * The default pipe size limits each cycle of the loop
+		 * below to moving 16 pages.  Sendfile of cached data is
+		 * dominated by per-cycle setup costs, so use a larger
+		 * ring for the internal pipe; the buffer array is tiny
+		 * and the pages only live for one cycle.  If resizing
+		 * fails, just stay with the default size.
+		 */
+		pipe_resize_ring(pipe, 4 * PIPE_DEF_BUFFERS);
+
 		/*
 		 * We don't have an immediate reader, but we'll read the stuff
 		 * out of the pipe right after the splice_to_pipe(). So set
@@ -430,18 +430,23 @@ xfs_iget_check_free_state(
 }
 
 /* Make all pending inactivation work start immediately. */
-static void
+static bool
 xfs_inodegc_queue_all(
 	struct xfs_mount	*mp)
 {
 	struct xfs_inodegc	*gc;
 	int			cpu;
+	bool			ret = false;
 
-	for_each_online_cpu(cpu) {
+	for_each_cpu(cpu, &mp->m_inodegc_cpumask) {
 		gc = per_cpu_ptr(mp->m_inodegc, cpu);
-		if (!llist_empty(&gc->list))
+		if (!llist_empty(&gc->list)) {
 			mod_delayed_work_on(cpu, mp->m_inodegc_wq, &gc->work, 0);
+			ret = true;
+		}
 	}
+
+	return ret;
 }
 
 /*
@@ -1845,6 +1850,16 @@ xfs_inodegc_worker(
 						struct xfs_inodegc, work);
 	struct llist_node	*node = llist_del_all(&gc->list);
 	struct xfs_inode	*ip, *n;
+	struct xfs_mount	*mp = gc->mp;
+
+	/*
+	 * Clear the cpumask bit and ensure that we have seen the latest update
+	 * of the gc structure associated with this CPU. This matches with the
+	 * full memory barrier that comes after setting this bit in
+	 * xfs_inodegc_queue().
+	 */
+	cpumask_clear_cpu(gc->cpu, &mp->m_inodegc_cpumask);
+	smp_mb__after_atomic();
 
 	WRITE_ONCE(gc->items, 0);
 
@@ -1899,7 +1914,16 @@ xfs_inodegc_stop(
 	if (!xfs_clear_inodegc_enabled(mp))
 		return;
 
-	xfs_inodegc_queue_all(mp);
+	/*
+	 * Drain all pending inodegc work, including inodes that could be
+	 * queued by racing xfs_inodegc_queue or xfs_inodegc_shrinker_scan
+	 * threads that sample the inodegc state just prior to us clearing it.
+	 * The inodegc flag state prevents new threads from queuing more
+	 * inodes, so we queue pending work items and flush the workqueue until
+	 * all inodegc lists are empty.
+	 */
+	while (xfs_inodegc_queue_all(mp))
+		flush_workqueue(mp->m_inodegc_wq);
 	drain_workqueue(mp->m_inodegc_wq);
 
 	trace_xfs_inodegc_stop(mp, __return_address);
@@ -2037,6 +2061,15 @@ xfs_inodegc_queue(
 	WRITE_ONCE(gc->items, items + 1);
 	shrinker_hits = READ_ONCE(gc->shrinker_hits);
 
+	/*
+	 * Ensure the list add is always seen by anyone who finds the cpumask
+	 * bit set. This effectively gives the cpumask bit set operation
+	 * release ordering semantics.
+	 */
+	smp_mb__before_atomic();
+	if (!cpumask_test_cpu(gc->cpu, &mp->m_inodegc_cpumask))
+		cpumask_test_and_set_cpu(gc->cpu, &mp->m_inodegc_cpumask);
+
 	/*
 	 * We queue the work while holding the current CPU so that the work
 	 * is scheduled to run on this CPU.
@@ -2074,8 +2107,10 @@ xfs_inodegc_cpu_dead(
 	dead_gc = per_cpu_ptr(mp->m_inodegc, dead_cpu);
 	cancel_delayed_work_sync(&dead_gc->work);
 
-	if (llist_empty(&dead_gc->list))
+	if (llist_empty(&dead_gc->list)) {
+		cpumask_clear_cpu(dead_cpu, &mp->m_inodegc_cpumask);
 		return;
+	}
 
 	first = dead_gc->list.first;
 	last = first;
@@ -2085,6 +2120,7 @@ xfs_inodegc_cpu_dead(
 	}
 	dead_gc->list.first = NULL;
 	dead_gc->items = 0;
+	cpumask_clear_cpu(dead_cpu, &mp->m_inodegc_cpumask);
 
 	/* Add pending work to current CPU */
 	gc = get_cpu_ptr(mp->m_inodegc);
@@ -2092,6 +2128,11 @@ xfs_inodegc_cpu_dead(
 	count += READ_ONCE(gc->items);
 	WRITE_ONCE(gc->items, count);
 
+	/* See xfs_inodegc_queue() for the cpumask ordering rules. */
+	smp_mb__before_atomic();
+	if (!cpumask_test_cpu(gc->cpu, &mp->m_inodegc_cpumask))
+		cpumask_test_and_set_cpu(gc->cpu, &mp->m_inodegc_cpumask);
+
 	if (xfs_is_inodegc_enabled(mp)) {
 		trace_xfs_inodegc_queue(mp, __return_address);
 		mod_delayed_work(mp->m_inodegc_wq, &gc->work, 0);
@@ -2160,7 +2201,7 @@ xfs_inodegc_shrinker_count(
 	if (!xfs_is_inodegc_enabled(mp))
 		return 0;
 
-	for_each_online_cpu(cpu) {
+	for_each_cpu(cpu, &mp->m_inodegc_cpumask) {
 		gc = per_cpu_ptr(mp->m_inodegc, cpu);
 		if (!llist_empty(&gc->list))
 			return XFS_INODEGC_SHRINKER_COUNT;
@@ -2185,7 +2226,7 @@ xfs_inodegc_shrinker_scan(
 
 	trace_xfs_inodegc_shrinker_scan(mp, sc, __return_address);
 
-	for_each_online_cpu(cpu) {
+	for_each_cpu(cpu, &mp->m_inodegc_cpumask) {
 		gc = per_cpu_ptr(mp->m_inodegc, cpu);
 		if (!llist_empty(&gc->list)) {
 			unsigned int	h = READ_ONCE(gc->shrinker_hits);
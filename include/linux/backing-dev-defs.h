@@ -147,6 +147,7 @@ struct bdi_writeback {
 	struct list_head work_list;
 	struct delayed_work dwork;	/* work item used for writeback */
 	struct delayed_work bw_dwork;	/* work item used for bandwidth estimate */
+	struct work_struct bg_work;	/* helper for background writeback */
 
 	unsigned long dirty_sleep;	/* last wait */
 
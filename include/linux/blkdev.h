@@ -289,9 +289,15 @@ void blk_queue_set_zoned(struct gendisk *disk, enum blk_zoned_model model);
 #ifdef CONFIG_BLK_DEV_ZONED
 
 #define BLK_ALL_ZONES  ((unsigned int)-1)
+
+/* seq_zones_wp_ofst value of a zone whose write pointer is not known */
+#define BLK_ZONE_WP_UNKNOWN	U32_MAX
+
 int blkdev_report_zones(struct block_device *bdev, sector_t sector,
 			unsigned int nr_zones, report_zones_cb cb, void *data);
 unsigned int blkdev_nr_zones(struct gendisk *disk);
+int bdev_zone_wp_offset(struct block_device *bdev, sector_t sector,
+			sector_t *wp_ofst);
 extern int blkdev_zone_mgmt(struct block_device *bdev, enum req_opf op,
 			    sector_t sectors, sector_t nr_sectors,
 			    gfp_t gfp_mask);
@@ -310,6 +316,12 @@ static inline unsigned int blkdev_nr_zones(struct gendisk *disk)
 	return 0;
 }
 
+static inline int bdev_zone_wp_offset(struct block_device *bdev,
+				      sector_t sector, sector_t *wp_ofst)
+{
+	return -EOPNOTSUPP;
+}
+
 static inline int blkdev_report_zones_ioctl(struct block_device *bdev,
 					    fmode_t mode, unsigned int cmd,
 					    unsigned long arg)
@@ -466,7 +478,10 @@ struct request_queue {
 	 * request targeting the zone was dispatched. All three fields are
 	 * initialized by the low level device driver (e.g. scsi/sd.c).
 	 * Stacking drivers (device mappers) may or may not initialize
-	 * these fields.
+	 * these fields. seq_zones_wp_ofst is an array of nr_zones write
+	 * pointer offsets, maintained by the block layer from write
+	 * completions as a hint to avoid report zones round trips; see
+	 * bdev_zone_wp_offset().
 	 *
 	 * Reads of this information must be protected with blk_queue_enter() /
 	 * blk_queue_exit(). Modifying this information is only allowed while
@@ -476,6 +491,7 @@ struct request_queue {
 	unsigned int		nr_zones;
 	unsigned long		*conv_zones_bitmap;
 	unsigned long		*seq_zones_wlock;
+	u32			*seq_zones_wp_ofst;
 	unsigned int		max_open_zones;
 	unsigned int		max_active_zones;
 #endif /* CONFIG_BLK_DEV_ZONED */
@@ -212,6 +212,27 @@ bool kthread_cancel_delayed_work_sync(struct kthread_delayed_work *work);
 
 void kthread_destroy_worker(struct kthread_worker *worker);
 
+/*
+ * A pool of kthread workers for bursty, short-lived jobs.  The workers
+ * (and hence their stacks) are allocated up front, so submission costs a
+ * wakeup rather than a kthread_create().
+ */
+struct kthread_worker_pool {
+	struct kthread_worker	**workers;
+	unsigned int		nr_workers;
+	atomic_t		next;
+};
+
+struct kthread_worker_pool *
+kthread_create_worker_pool(unsigned int nr_workers, unsigned int flags,
+			   const char *name);
+
+bool kthread_pool_queue_work(struct kthread_worker_pool *pool,
+			     struct kthread_work *work);
+
+void kthread_flush_worker_pool(struct kthread_worker_pool *pool);
+void kthread_destroy_worker_pool(struct kthread_worker_pool *pool);
+
 void kthread_use_mm(struct mm_struct *mm);
 void kthread_unuse_mm(struct mm_struct *mm);
 
@@ -608,6 +608,67 @@ struct vm_operations_struct {
 					  unsigned long addr);
 };
 
+#ifdef CONFIG_PER_VMA_LOCK
+static inline void vma_lock_init(struct vm_area_struct *vma)
+{
+	init_rwsem(&vma->vm_lock);
+}
+
+/*
+ * Pin @vma so a page fault can keep using it after mmap_lock is dropped.
+ * Must be called with mmap_lock held; failure means a writer is draining
+ * the VMA and the caller should stay on the mmap_lock path.
+ */
+static inline bool vma_start_read(struct vm_area_struct *vma)
+{
+	mmap_assert_locked(vma->vm_mm);
+	return down_read_trylock(&vma->vm_lock) != 0;
+}
+
+static inline void vma_end_read(struct vm_area_struct *vma)
+{
+	up_read(&vma->vm_lock);
+}
+
+/*
+ * Wait out lock-free page faults before modifying a VMA or tearing down
+ * its page tables.  mmap_lock must be held for writing, which keeps new
+ * readers from looking the VMA up, so a plain drain is sufficient.
+ */
+static inline void vma_start_write(struct vm_area_struct *vma)
+{
+	mmap_assert_write_locked(vma->vm_mm);
+	down_write(&vma->vm_lock);
+	up_write(&vma->vm_lock);
+}
+
+/*
+ * Stack expansion modifies a VMA while holding mmap_lock only for
+ * reading, so draining is not enough: new lock-free faults can keep
+ * pinning the VMA throughout.  Hold the VMA lock across the update
+ * instead.  Must be taken before the anon_vma lock; the fault path
+ * acquires the VMA lock first, too.
+ */
+static inline void vma_write_lock(struct vm_area_struct *vma)
+{
+	down_write(&vma->vm_lock);
+}
+
+static inline void vma_write_unlock(struct vm_area_struct *vma)
+{
+	up_write(&vma->vm_lock);
+}
+
+#else /* !CONFIG_PER_VMA_LOCK */
+static inline void vma_lock_init(struct vm_area_struct *vma) {}
+static inline bool vma_start_read(struct vm_area_struct *vma)
+	{ return false; }
+static inline void vma_end_read(struct vm_area_struct *vma) {}
+static inline void vma_start_write(struct vm_area_struct *vma) {}
+static inline void vma_write_lock(struct vm_area_struct *vma) {}
+static inline void vma_write_unlock(struct vm_area_struct *vma) {}
+#endif /* CONFIG_PER_VMA_LOCK */
+
 static inline void vma_init(struct vm_area_struct *vma, struct mm_struct *mm)
 {
 	static const struct vm_operations_struct dummy_vm_ops = {};
@@ -616,6 +677,7 @@ static inline void vma_init(struct vm_area_struct *vma, struct mm_struct *mm)
 	vma->vm_mm = mm;
 	vma->vm_ops = &dummy_vm_ops;
 	INIT_LIST_HEAD(&vma->anon_vma_chain);
+	vma_lock_init(vma);
 }
 
 static inline void vma_set_anonymous(struct vm_area_struct *vma)
@@ -628,6 +690,25 @@ static inline bool vma_is_anonymous(struct vm_area_struct *vma)
 	return !vma->vm_ops;
 }
 
+#ifdef CONFIG_PER_VMA_LOCK
+/*
+ * Only anonymous VMAs qualify for the lock-free fault path for now:
+ * file faults may drop mmap_lock inside the fault handler, anon_vma
+ * setup requires mmap_lock, and userfaultfd arming is serialized only
+ * by mmap_lock.
+ */
+static inline bool vma_can_lock_fault(struct vm_area_struct *vma)
+{
+	return vma_is_anonymous(vma) && vma->anon_vma &&
+	       !(vma->vm_flags & (VM_UFFD_MISSING | VM_UFFD_WP | VM_UFFD_MINOR));
+}
+#else
+static inline bool vma_can_lock_fault(struct vm_area_struct *vma)
+{
+	return false;
+}
+#endif
+
 static inline bool vma_is_temporary_stack(struct vm_area_struct *vma)
 {
 	int maybe_stack = vma->vm_flags & (VM_GROWSDOWN | VM_GROWSUP);
@@ -1846,6 +1927,9 @@ void zap_vma_ptes(struct vm_area_struct *vma, unsigned long address,
 		  unsigned long size);
 void zap_page_range(struct vm_area_struct *vma, unsigned long address,
 		    unsigned long size);
+void zap_page_range_batched(struct mmu_gather *tlb,
+			    struct vm_area_struct *vma, unsigned long address,
+			    unsigned long size);
 void unmap_vmas(struct mmu_gather *tlb, struct vm_area_struct *start_vma,
 		unsigned long start, unsigned long end);
 
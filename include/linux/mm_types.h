@@ -456,6 +456,16 @@ struct vm_area_struct {
 					  * page_table_lock */
 	struct anon_vma *anon_vma;	/* Serialized by page_table_lock */
 
+#ifdef CONFIG_PER_VMA_LOCK
+	/*
+	 * Lets a page fault pin this VMA and run without mmap_lock.
+	 * Readers acquire it (trylock) while holding mmap_lock; writers
+	 * drain it via vma_start_write() under mmap_write_lock before
+	 * modifying the VMA or tearing down its page tables.
+	 */
+	struct rw_semaphore vm_lock;
+#endif
+
 	/* Function pointers to deal with this struct. */
 	const struct vm_operations_struct *vm_ops;
 
@@ -657,6 +667,13 @@ struct mm_struct {
 #endif
 		struct work_struct async_put_work;
 
+#ifdef CONFIG_FUTEX
+		/*
+		 * Home node of the private futex hash; nailed down by the
+		 * first futex operation, NUMA_NO_NODE until then.
+		 */
+		int futex_node;
+#endif
 #ifdef CONFIG_IOMMU_SVA
 		u32 pasid;
 #endif
@@ -829,6 +846,10 @@ typedef struct {
  *                      mapped R/O.
  * @FAULT_FLAG_ORIG_PTE_VALID: whether the fault has vmf->orig_pte cached.
  *                        We should only access orig_pte if this flag set.
+ * @FAULT_FLAG_VMA_LOCK: The fault is handled under the per-VMA lock with
+ *                       mmap_lock already dropped; handlers that would
+ *                       need mmap_lock must return VM_FAULT_RETRY without
+ *                       releasing anything.
  *
  * About @FAULT_FLAG_ALLOW_RETRY and @FAULT_FLAG_TRIED: we can specify
  * whether we would allow page faults to retry by specifying these two
@@ -866,6 +887,7 @@ enum fault_flag {
 	FAULT_FLAG_INTERRUPTIBLE =	1 << 9,
 	FAULT_FLAG_UNSHARE =		1 << 10,
 	FAULT_FLAG_ORIG_PTE_VALID =	1 << 11,
+	FAULT_FLAG_VMA_LOCK =		1 << 12,
 };
 
 typedef unsigned int __bitwise zap_flags_t;
@@ -25,9 +25,12 @@
 #define ALLOC_SPLIT_PTLOCKS	(SPINLOCK_SIZE > BITS_PER_LONG/8)
 
 /*
- * The per task VMA cache array:
+ * The per task VMA cache array.  Eight slots fill exactly one cache line
+ * of pointers on 64-bit, which noticeably cuts rbtree descents for
+ * address-space-heavy workloads (many thousands of VMAs) at no extra
+ * lookup cost.
  */
-#define VMACACHE_BITS 2
+#define VMACACHE_BITS 3
 #define VMACACHE_SIZE (1U << VMACACHE_BITS)
 #define VMACACHE_MASK (VMACACHE_SIZE - 1)
 
@@ -2,6 +2,7 @@
 #ifndef _LINUX_PSI_TYPES_H
 #define _LINUX_PSI_TYPES_H
 
+#include <linux/cpumask.h>
 #include <linux/kthread.h>
 #include <linux/seqlock.h>
 #include <linux/types.h>
@@ -153,6 +154,12 @@ struct psi_group {
 	/* Per-cpu task state & time tracking */
 	struct psi_group_cpu __percpu *pcpu;
 
+	/*
+	 * CPUs with task state changes that each aggregator has not
+	 * folded in yet; quiescent CPUs are skipped during collection.
+	 */
+	struct cpumask changed_cpus[NR_PSI_AGGREGATORS];
+
 	/* Running pressure averages */
 	u64 avg_total[NR_PSI_STATES - 1];
 	u64 avg_last_update;
@@ -773,6 +773,8 @@ struct task_struct {
 	int				static_prio;
 	int				normal_prio;
 	unsigned int			rt_priority;
+	/* Latency requirement hint, see SCHED_FLAG_LATENCY_NICE */
+	int				latency_nice;
 
 	struct sched_entity		se;
 	struct sched_rt_entity		rt;
@@ -42,4 +42,18 @@ static inline long rlimit_to_nice(long prio)
 	return (MAX_NICE - prio + 1);
 }
 
+/*
+ * Latency nice is meant to provide scheduler hints about the relative
+ * latency requirements of a task with respect to other tasks.
+ * Latency nice can have any value in a range of [MIN_NICE..MAX_NICE].
+ *
+ * A task with latency_nice == 19 can be preempted less readily on
+ * wakeup of other tasks, while a task with latency_nice == -20 gets
+ * preference to run quickly after it wakes up.  The default value is 0.
+ */
+#define MAX_LATENCY_NICE	MAX_NICE
+#define MIN_LATENCY_NICE	MIN_NICE
+#define LATENCY_NICE_WIDTH	(MAX_LATENCY_NICE - MIN_LATENCY_NICE + 1)
+#define DEFAULT_LATENCY_NICE	0
+
 #endif /* _LINUX_SCHED_PRIO_H */
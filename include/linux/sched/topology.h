@@ -81,6 +81,13 @@ struct sched_domain_shared {
 	atomic_t	ref;
 	atomic_t	nr_busy_cpus;
 	int		has_idle_cores;
+	/*
+	 * CPUs of this LLC that went through the idle loop since they last
+	 * ran a task.  Maintained from the idle path only, so a bit may be
+	 * stale in both directions; wakeup placement treats set bits as
+	 * hints and re-verifies the CPU before using it.
+	 */
+	struct cpumask	idle_cpus_span;
 };
 
 struct sched_domain {
@@ -87,10 +87,10 @@ extern void shmem_truncate_range(struct inode *inode, loff_t start, loff_t end);
 int shmem_unuse(unsigned int type);
 
 extern bool shmem_is_huge(struct vm_area_struct *vma,
-			  struct inode *inode, pgoff_t index);
+			  struct inode *inode, pgoff_t index, loff_t write_end);
 static inline bool shmem_huge_enabled(struct vm_area_struct *vma)
 {
-	return shmem_is_huge(vma, file_inode(vma->vm_file), vma->vm_pgoff);
+	return shmem_is_huge(vma, file_inode(vma->vm_file), vma->vm_pgoff, 0);
 }
 extern unsigned long shmem_swap_usage(struct vm_area_struct *vma);
 extern unsigned long shmem_partial_swap_usage(struct address_space *mapping,
@@ -105,7 +105,7 @@ enum sgp_type {
 	SGP_FALLOC,	/* like SGP_WRITE, but make existing page Uptodate */
 };
 
-extern int shmem_getpage(struct inode *inode, pgoff_t index,
+extern int shmem_getpage(struct inode *inode, pgoff_t index, loff_t write_end,
 		struct page **pagep, enum sgp_type sgp);
 
 static inline struct page *shmem_read_mapping_page(
@@ -13,6 +13,7 @@
 struct file;
 struct pid;
 struct cred;
+struct ubuf_info;
 struct socket;
 
 #define __sockaddr_check_size(size)	\
@@ -69,6 +70,9 @@ struct msghdr {
 	unsigned int	msg_flags;	/* flags on received message */
 	__kernel_size_t	msg_controllen;	/* ancillary data buffer length */
 	struct kiocb	*msg_iocb;	/* ptr to iocb for async requests */
+	struct ubuf_info *msg_ubuf;	/* optional caller provided zerocopy
+					 * completion context, only honoured
+					 * with MSG_ZEROCOPY */
 };
 
 struct user_msghdr {
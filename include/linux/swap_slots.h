@@ -6,7 +6,12 @@
 #include <linux/spinlock.h>
 #include <linux/mutex.h>
 
-#define SWAP_SLOTS_CACHE_SIZE			SWAP_BATCH
+/*
+ * Two SWAP_BATCH worth of slots per refill: on fast NVMe swap devices
+ * the refill trip into get_swap_pages() - and with it si->lock - is
+ * the limiter, so halve how often the per-CPU cache has to take it.
+ */
+#define SWAP_SLOTS_CACHE_SIZE			(2 * SWAP_BATCH)
 #define THRESHOLD_ACTIVATE_SWAP_SLOTS_CACHE	(5*SWAP_SLOTS_CACHE_SIZE)
 #define THRESHOLD_DEACTIVATE_SWAP_SLOTS_CACHE	(2*SWAP_SLOTS_CACHE_SIZE)
 
@@ -0,0 +1,41 @@
+/* SPDX-License-Identifier: GPL-2.0 WITH Linux-syscall-note */
+#ifndef _TRACE_MMAP_H_
+#define _TRACE_MMAP_H_
+
+#include <linux/ioctl.h>
+#include <linux/types.h>
+
+/**
+ * struct trace_buffer_meta - meta page of an mmap'ed per-CPU ring buffer
+ * @meta_page_size:	Size of this meta page.
+ * @subbuf_size:	Size of each sub-buffer, including its header.
+ * @nr_subbufs:		Number of sub-buffers, reader page included.
+ * @reader_id:		Sub-buffer id of the current reader page.
+ * @reader_read:	Offset of the first unread byte on the reader page.
+ * @reader_commit:	Offset past the last valid byte on the reader page.
+ * @reader_lost_events:	Events lost just before the reader page was taken.
+ * @entries:		Number of entries written to the buffer.
+ * @overrun:		Number of entries lost to overwrites.
+ * @read:		Number of entries consumed so far.
+ *
+ * Mapping a per_cpu/cpuN/trace_pipe_raw file read-only yields this page at
+ * offset 0, followed by the sub-buffers, laid out by their id.  The kernel
+ * updates the page on TRACE_MMAP_IOCTL_GET_READER, which also flips in a
+ * fresh reader page once the current one has been fully consumed.
+ */
+struct trace_buffer_meta {
+	__u32	meta_page_size;
+	__u32	subbuf_size;
+	__u32	nr_subbufs;
+	__u32	reader_id;
+	__u32	reader_read;
+	__u32	reader_commit;
+	__u64	reader_lost_events;
+	__u64	entries;
+	__u64	overrun;
+	__u64	read;
+};
+
+#define TRACE_MMAP_IOCTL_GET_READER		_IO('T', 0x1)
+
+#endif /* _TRACE_MMAP_H_ */
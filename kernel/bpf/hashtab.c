@@ -94,6 +94,8 @@ struct bpf_htab {
 	struct bpf_map map;
 	struct bucket *buckets;
 	void *elems;
+	void **node_elems;	/* per-node prealloc areas, if NUMA-local */
+	u32 *node_entries;	/* number of elements in each node area */
 	union {
 		struct pcpu_freelist freelist;
 		struct bpf_lru lru;
@@ -224,8 +226,27 @@ static void *fd_htab_map_get_ptr(const struct bpf_map *map, struct htab_elem *l)
 	return *(void **)(l->key + roundup(map->key_size, 8));
 }
 
+static int htab_cpu_node(int cpu)
+{
+	int node = cpu_to_node(cpu);
+
+	return node == NUMA_NO_NODE ? 0 : node;
+}
+
 static struct htab_elem *get_htab_elem(struct bpf_htab *htab, int i)
 {
+	if (htab->node_elems) {
+		int node;
+
+		for_each_node(node) {
+			if ((u32)i < htab->node_entries[node])
+				break;
+			i -= htab->node_entries[node];
+		}
+		return (struct htab_elem *) (htab->node_elems[node] +
+					     i * (u64)htab->elem_size);
+	}
+
 	return (struct htab_elem *) (htab->elems + i * (u64)htab->elem_size);
 }
 
@@ -290,6 +311,17 @@ static void htab_free_elems(struct bpf_htab *htab)
 		cond_resched();
 	}
 free_elems:
+	if (htab->node_elems) {
+		int node;
+
+		for_each_node(node)
+			bpf_map_area_free(htab->node_elems[node]);
+		kfree(htab->node_elems);
+		kfree(htab->node_entries);
+		htab->node_elems = NULL;
+		htab->node_entries = NULL;
+		return;
+	}
 	bpf_map_area_free(htab->elems);
 }
 
@@ -323,6 +355,78 @@ static struct htab_elem *prealloc_lru_pop(struct bpf_htab *htab, void *key,
 	return NULL;
 }
 
+/* Spread the preallocated area over the nodes of the possible CPUs, giving
+ * each CPU the elements that live on its own node.  Together with the
+ * node-local population of the per-CPU freelists this keeps preallocated
+ * elements popped on a CPU out of remote DRAM.  Failure here is not fatal:
+ * the caller falls back to a single area on htab->map.numa_node.
+ */
+static int prealloc_init_numa(struct bpf_htab *htab, u32 num_entries)
+{
+	u32 base = num_entries / num_possible_cpus();
+	u32 rem = num_entries % num_possible_cpus();
+	u32 i = 0, *node_entries;
+	void **node_elems;
+	int node, cpu;
+
+	node_elems = kcalloc(nr_node_ids, sizeof(*node_elems),
+			     GFP_USER | __GFP_NOWARN);
+	node_entries = kcalloc(nr_node_ids, sizeof(*node_entries),
+			       GFP_USER | __GFP_NOWARN);
+	if (!node_elems || !node_entries)
+		goto free;
+
+	for_each_possible_cpu(cpu)
+		node_entries[htab_cpu_node(cpu)] += base + (i++ < rem);
+
+	for_each_node(node) {
+		if (!node_entries[node])
+			continue;
+		node_elems[node] =
+			bpf_map_area_alloc((u64)htab->elem_size *
+					   node_entries[node], node);
+		if (!node_elems[node])
+			goto free;
+	}
+
+	htab->node_elems = node_elems;
+	htab->node_entries = node_entries;
+	return 0;
+
+free:
+	if (node_elems) {
+		for_each_node(node)
+			bpf_map_area_free(node_elems[node]);
+	}
+	kfree(node_elems);
+	kfree(node_entries);
+	return -ENOMEM;
+}
+
+static void prealloc_populate_numa(struct bpf_htab *htab, u32 num_entries)
+{
+	u32 base = num_entries / num_possible_cpus();
+	u32 rem = num_entries % num_possible_cpus();
+	int node, cpu;
+
+	for_each_node(node) {
+		void *buf = htab->node_elems[node];
+		u32 i = 0, nr;
+
+		if (!buf)
+			continue;
+		buf += offsetof(struct htab_elem, fnode);
+		for_each_possible_cpu(cpu) {
+			nr = base + (i++ < rem);
+			if (htab_cpu_node(cpu) != node)
+				continue;
+			pcpu_freelist_populate_cpu(&htab->freelist, cpu, buf,
+						   htab->elem_size, nr);
+			buf += (u64)nr * htab->elem_size;
+		}
+	}
+}
+
 static int prealloc_init(struct bpf_htab *htab)
 {
 	u32 num_entries = htab->map.max_entries;
@@ -331,10 +435,17 @@ static int prealloc_init(struct bpf_htab *htab)
 	if (htab_has_extra_elems(htab))
 		num_entries += num_possible_cpus();
 
-	htab->elems = bpf_map_area_alloc((u64)htab->elem_size * num_entries,
-					 htab->map.numa_node);
-	if (!htab->elems)
-		return -ENOMEM;
+	if (htab_has_extra_elems(htab) &&
+	    htab->map.numa_node == NUMA_NO_NODE && nr_node_ids > 1)
+		prealloc_init_numa(htab, num_entries);
+
+	if (!htab->node_elems) {
+		htab->elems = bpf_map_area_alloc((u64)htab->elem_size *
+						 num_entries,
+						 htab->map.numa_node);
+		if (!htab->elems)
+			return -ENOMEM;
+	}
 
 	if (!htab_is_percpu(htab))
 		goto skip_percpu_elems;
@@ -370,6 +481,8 @@ skip_percpu_elems:
 		bpf_lru_populate(&htab->lru, htab->elems,
 				 offsetof(struct htab_elem, lru_node),
 				 htab->elem_size, num_entries);
+	else if (htab->node_elems)
+		prealloc_populate_numa(htab, num_entries);
 	else
 		pcpu_freelist_populate(&htab->freelist,
 				       htab->elems + offsetof(struct htab_elem, fnode),
@@ -121,11 +121,32 @@ again:
 	}
 }
 
+/* Populate @cpu's list only, for callers that place elements by node. */
+void pcpu_freelist_populate_cpu(struct pcpu_freelist *s, int cpu, void *buf,
+				u32 elem_size, u32 nr_elems)
+{
+	struct pcpu_freelist_head *head = per_cpu_ptr(s->freelist, cpu);
+	u32 i;
+
+	/* No locking required as this is not visible yet. */
+	for (i = 0; i < nr_elems; i++) {
+		pcpu_freelist_push_node(head, buf);
+		buf += elem_size;
+	}
+}
+
+/* Number of elements moved to the local list when stealing from another
+ * CPU.  Batching amortizes the cross-CPU scan: under churn the next
+ * pops are served locally instead of walking remote lists again.
+ */
+#define PCPU_FREELIST_STEAL_BATCH	16
+
 static struct pcpu_freelist_node *___pcpu_freelist_pop(struct pcpu_freelist *s)
 {
+	struct pcpu_freelist_node *node, *tail;
 	struct pcpu_freelist_head *head;
-	struct pcpu_freelist_node *node;
 	int orig_cpu, cpu;
+	unsigned int i;
 
 	orig_cpu = cpu = raw_smp_processor_id();
 	while (1) {
@@ -133,8 +154,29 @@ static struct pcpu_freelist_node *___pcpu_freelist_pop(struct pcpu_freelist *s)
 		raw_spin_lock(&head->lock);
 		node = head->first;
 		if (node) {
-			head->first = node->next;
+			if (cpu == orig_cpu) {
+				head->first = node->next;
+				raw_spin_unlock(&head->lock);
+				return node;
+			}
+			/* Steal a batch, not just one element */
+			tail = node;
+			for (i = 1; i < PCPU_FREELIST_STEAL_BATCH; i++) {
+				if (!tail->next)
+					break;
+				tail = tail->next;
+			}
+			head->first = tail->next;
 			raw_spin_unlock(&head->lock);
+
+			/* Keep everything past @node for local reuse */
+			if (node->next) {
+				head = per_cpu_ptr(s->freelist, orig_cpu);
+				raw_spin_lock(&head->lock);
+				tail->next = head->first;
+				head->first = node->next;
+				raw_spin_unlock(&head->lock);
+			}
 			return node;
 		}
 		raw_spin_unlock(&head->lock);
@@ -28,6 +28,8 @@ void __pcpu_freelist_push(struct pcpu_freelist *, struct pcpu_freelist_node *);
 struct pcpu_freelist_node *__pcpu_freelist_pop(struct pcpu_freelist *);
 void pcpu_freelist_populate(struct pcpu_freelist *s, void *buf, u32 elem_size,
 			    u32 nr_elems);
+void pcpu_freelist_populate_cpu(struct pcpu_freelist *s, int cpu, void *buf,
+				u32 elem_size, u32 nr_elems);
 int pcpu_freelist_init(struct pcpu_freelist *);
 void pcpu_freelist_destroy(struct pcpu_freelist *s);
 #endif
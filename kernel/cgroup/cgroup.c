@@ -2840,7 +2840,11 @@ struct task_struct *cgroup_procs_write_start(char *buf, bool threadgroup,
 	 */
 	lockdep_assert_held(&cgroup_mutex);
 	if (pid || threadgroup) {
-		percpu_down_write(&cgroup_threadgroup_rwsem);
+		/*
+		 * Expedited to keep attach latency in the microseconds;
+		 * writes here are rare relative to the fork/exit readers.
+		 */
+		percpu_down_write_expedited(&cgroup_threadgroup_rwsem);
 		*locked = true;
 	} else {
 		*locked = false;
@@ -2953,7 +2957,7 @@ static int cgroup_update_dfl_csses(struct cgroup *cgrp)
 
 	lockdep_assert_held(&cgroup_mutex);
 
-	percpu_down_write(&cgroup_threadgroup_rwsem);
+	percpu_down_write_expedited(&cgroup_threadgroup_rwsem);
 
 	/* look up all csses currently attached to @cgrp's subtree */
 	spin_lock_irq(&css_set_lock);
@@ -155,6 +155,17 @@ static void cgroup_rstat_flush_locked(struct cgroup *cgrp, bool may_sleep)
 		struct cgroup *pos = NULL;
 		unsigned long flags;
 
+		/*
+		 * Speculative not-on-list test.  Updates link @cgrp and all
+		 * its ancestors bottom-up, so if nothing in @cgrp's subtree
+		 * was updated on this CPU, @cgrp itself is not on the list
+		 * and the whole CPU can be skipped without taking its lock.
+		 * A racing update after this test is no different from one
+		 * arriving right after this CPU's flush.
+		 */
+		if (!data_race(cgroup_rstat_cpu(cgrp, cpu)->updated_next))
+			continue;
+
 		/*
 		 * The _irqsave() is needed because cgroup_rstat_lock is
 		 * spinlock_t which is a sleeping lock on PREEMPT_RT. Acquiring
@@ -37,6 +37,7 @@
 #include <linux/memblock.h>
 #include <linux/fault-inject.h>
 #include <linux/slab.h>
+#include <linux/vmalloc.h>
 
 #include "futex.h"
 #include "../locking/rtmutex_common.h"
@@ -53,6 +54,15 @@ static struct {
 #define futex_queues   (__futex_data.queues)
 #define futex_hashsize (__futex_data.hashsize)
 
+#ifdef CONFIG_NUMA
+/*
+ * Node-local bucket arrays for private futexes, same geometry as the
+ * global table.  A NULL slot (memoryless node, or allocation failure at
+ * boot) falls back to the global table.
+ */
+static struct futex_hash_bucket *futex_node_queues[MAX_NUMNODES] __read_mostly;
+#endif
+
 
 /*
  * Fault injections for futexes.
@@ -106,18 +116,39 @@ late_initcall(fail_futex_debugfs);
 #endif /* CONFIG_FAIL_FUTEX */
 
 /**
- * futex_hash - Return the hash bucket in the global hash
+ * futex_hash - Return the hash bucket for a futex key
  * @key:	Pointer to the futex key for which the hash is calculated
  *
- * We hash on the keys returned from get_futex_key (see below) and return the
- * corresponding hash bucket in the global hash.
+ * We hash on the keys returned from get_futex_key (see below).  Private
+ * futexes are only ever keyed by threads sharing one mm, so their buckets
+ * can live in a table on that mm's home node, keeping the bucket cache
+ * lines on-socket for node-pinned processes.  The home node is nailed
+ * down by whichever thread gets here first; every thread of the mm then
+ * agrees on the bucket.  Shared futexes use the global table.
  */
 struct futex_hash_bucket *futex_hash(union futex_key *key)
 {
 	u32 hash = jhash2((u32 *)key, offsetof(typeof(*key), both.offset) / 4,
 			  key->both.offset);
-
-	return &futex_queues[hash & (futex_hashsize - 1)];
+	struct futex_hash_bucket *queues = futex_queues;
+
+#ifdef CONFIG_NUMA
+	if (key->both.ptr &&
+	    !(key->both.offset & (FUT_OFF_INODE | FUT_OFF_MMSHARED))) {
+		struct mm_struct *mm = key->private.mm;
+		int node = READ_ONCE(mm->futex_node);
+
+		if (unlikely(node == NUMA_NO_NODE)) {
+			node = numa_node_id();
+			if (cmpxchg(&mm->futex_node, NUMA_NO_NODE, node) !=
+			    NUMA_NO_NODE)
+				node = READ_ONCE(mm->futex_node);
+		}
+		if (futex_node_queues[node])
+			queues = futex_node_queues[node];
+	}
+#endif
+	return &queues[hash & (futex_hashsize - 1)];
 }
 
 
@@ -1112,10 +1143,43 @@ void futex_exit_release(struct task_struct *tsk)
 	futex_cleanup_end(tsk, FUTEX_STATE_DEAD);
 }
 
+static void __init futex_queues_init(struct futex_hash_bucket *queues)
+{
+	unsigned long i;
+
+	for (i = 0; i < futex_hashsize; i++) {
+		atomic_set(&queues[i].waiters, 0);
+		plist_head_init(&queues[i].chain);
+		spin_lock_init(&queues[i].lock);
+	}
+}
+
+#ifdef CONFIG_NUMA
+static void __init futex_init_node_queues(void)
+{
+	int node;
+
+	if (nr_node_ids <= 1)
+		return;
+
+	for_each_node_state(node, N_MEMORY) {
+		struct futex_hash_bucket *queues;
+
+		queues = vzalloc_node(futex_hashsize * sizeof(*queues), node);
+		if (!queues)
+			continue;
+
+		futex_queues_init(queues);
+		futex_node_queues[node] = queues;
+	}
+}
+#else
+static inline void futex_init_node_queues(void) { }
+#endif
+
 static int __init futex_init(void)
 {
 	unsigned int futex_shift;
-	unsigned long i;
 
 #if CONFIG_BASE_SMALL
 	futex_hashsize = 16;
@@ -1130,11 +1194,8 @@ static int __init futex_init(void)
 					       futex_hashsize, futex_hashsize);
 	futex_hashsize = 1UL << futex_shift;
 
-	for (i = 0; i < futex_hashsize; i++) {
-		atomic_set(&futex_queues[i].waiters, 0);
-		plist_head_init(&futex_queues[i].chain);
-		spin_lock_init(&futex_queues[i].lock);
-	}
+	futex_queues_init(futex_queues);
+	futex_init_node_queues();
 
 	return 0;
 }
@@ -302,6 +302,47 @@ SYSCALL_DEFINE5(futex_waitv, struct futex_waitv __user *, waiters,
 	return ret;
 }
 
+/**
+ * sys_futex_wakev - Wake waiters on a list of futexes
+ * @waiters:    List of futexes to wake
+ * @nr_futexes: Length of futexv
+ * @flags:      Reserved, must be 0
+ *
+ * Given an array of `struct futex_waitv`, wake up to `val` waiters on each
+ * uaddr in a single syscall. Entries hashing to the same bucket are handled
+ * under one hash bucket lock acquisition. Each waiter has individual flags;
+ * the `__reserved` field must be 0 and is ignored otherwise.
+ *
+ * Returns the total number of waiters woken, or a negative error code. On
+ * error some of the earlier futexes in the array may already have been
+ * woken.
+ */
+
+SYSCALL_DEFINE3(futex_wakev, struct futex_waitv __user *, waiters,
+		unsigned int, nr_futexes, unsigned int, flags)
+{
+	struct futex_vector *futexv;
+	int ret;
+
+	/* This syscall supports no flags for now */
+	if (flags)
+		return -EINVAL;
+
+	if (!nr_futexes || nr_futexes > FUTEX_WAITV_MAX || !waiters)
+		return -EINVAL;
+
+	futexv = kcalloc(nr_futexes, sizeof(*futexv), GFP_KERNEL);
+	if (!futexv)
+		return -ENOMEM;
+
+	ret = futex_parse_waitv(futexv, waiters, nr_futexes);
+	if (!ret)
+		ret = futex_wake_multiple(futexv, nr_futexes);
+
+	kfree(futexv);
+	return ret;
+}
+
 #ifdef CONFIG_COMPAT
 COMPAT_SYSCALL_DEFINE2(set_robust_list,
 		struct compat_robust_list_head __user *, head,
@@ -185,6 +185,86 @@ int futex_wake(u32 __user *uaddr, unsigned int flags, int nr_wake, u32 bitset)
 	return ret;
 }
 
+/**
+ * futex_wake_multiple - Wake waiters on a list of futexes
+ * @vs:		The futex list to wake, with w.val waiters woken per entry
+ * @count:	The size of the list
+ *
+ * Wake up to vs[i].w.val waiters on each futex in the vector. Entries
+ * hashing to the same bucket are handled together, so each bucket lock is
+ * taken at most once per call and all wakeups happen in a single pass.
+ *
+ * Return: the number of woken waiters on success, <0 on error.
+ */
+int futex_wake_multiple(struct futex_vector *vs, unsigned int count)
+{
+	DECLARE_BITMAP(handled, FUTEX_WAITV_MAX);
+	DEFINE_WAKE_Q(wake_q);
+	unsigned int i, j;
+	int woken = 0;
+	int ret;
+
+	for (i = 0; i < count; i++) {
+		ret = get_futex_key(u64_to_user_ptr(vs[i].w.uaddr),
+				    !(vs[i].w.flags & FUTEX_PRIVATE_FLAG),
+				    &vs[i].q.key, FUTEX_READ);
+		if (unlikely(ret))
+			return ret;
+	}
+
+	bitmap_zero(handled, count);
+
+	for (i = 0; i < count; i++) {
+		struct futex_hash_bucket *hb;
+		struct futex_q *this, *next;
+		bool pending;
+
+		if (test_bit(i, handled))
+			continue;
+
+		hb = futex_hash(&vs[i].q.key);
+		pending = futex_hb_waiters_pending(hb);
+		if (pending)
+			spin_lock(&hb->lock);
+
+		/* Handle every entry that hashes to this bucket */
+		for (j = i; j < count; j++) {
+			int nr_wake = (int)vs[j].w.val;
+			int nr = 0;
+
+			if (test_bit(j, handled) ||
+			    futex_hash(&vs[j].q.key) != hb)
+				continue;
+
+			__set_bit(j, handled);
+			if (!pending)
+				continue;
+
+			plist_for_each_entry_safe(this, next, &hb->chain, list) {
+				if (!futex_match(&this->key, &vs[j].q.key))
+					continue;
+
+				if (this->pi_state || this->rt_waiter) {
+					spin_unlock(&hb->lock);
+					wake_up_q(&wake_q);
+					return -EINVAL;
+				}
+
+				futex_wake_mark(&wake_q, this);
+				if (++nr >= nr_wake)
+					break;
+			}
+			woken += nr;
+		}
+
+		if (pending)
+			spin_unlock(&hb->lock);
+	}
+
+	wake_up_q(&wake_q);
+	return woken;
+}
+
 static int futex_atomic_op_inuser(unsigned int encoded_op, u32 __user *uaddr)
 {
 	unsigned int op =	  (encoded_op & 0x70000000) >> 28;
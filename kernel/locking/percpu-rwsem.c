@@ -215,14 +215,18 @@ static bool readers_active_check(struct percpu_rw_semaphore *sem)
 	return true;
 }
 
-void __sched percpu_down_write(struct percpu_rw_semaphore *sem)
+static void __sched __percpu_down_write(struct percpu_rw_semaphore *sem,
+					bool expedited)
 {
 	might_sleep();
 	rwsem_acquire(&sem->dep_map, 0, 0, _RET_IP_);
 	trace_contention_begin(sem, LCB_F_PERCPU | LCB_F_WRITE);
 
 	/* Notify readers to take the slow path. */
-	rcu_sync_enter(&sem->rss);
+	if (expedited)
+		rcu_sync_enter_expedited(&sem->rss);
+	else
+		rcu_sync_enter(&sem->rss);
 
 	/*
 	 * Try set sem->block; this provides writer-writer exclusion.
@@ -243,8 +247,25 @@ void __sched percpu_down_write(struct percpu_rw_semaphore *sem)
 	rcuwait_wait_event(&sem->writer, readers_active_check(sem), TASK_UNINTERRUPTIBLE);
 	trace_contention_end(sem, 0);
 }
+
+void __sched percpu_down_write(struct percpu_rw_semaphore *sem)
+{
+	__percpu_down_write(sem, false);
+}
 EXPORT_SYMBOL_GPL(percpu_down_write);
 
+/*
+ * Like percpu_down_write(), but switches the readers onto their slow path
+ * via an expedited grace period when the semaphore is idle.  The writer
+ * waits microseconds instead of milliseconds, at the cost of IPI-ing all
+ * CPUs; reserved for low-frequency, latency-sensitive updaters.
+ */
+void __sched percpu_down_write_expedited(struct percpu_rw_semaphore *sem)
+{
+	__percpu_down_write(sem, true);
+}
+EXPORT_SYMBOL_GPL(percpu_down_write_expedited);
+
 void percpu_up_write(struct percpu_rw_semaphore *sem)
 {
 	rwsem_release(&sem->dep_map, _RET_IP_);
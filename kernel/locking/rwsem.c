@@ -1010,6 +1010,35 @@ rwsem_down_read_slowpath(struct rw_semaphore *sem, long count, unsigned int stat
 	    (rcnt > 1) && !(count & RWSEM_WRITER_LOCKED))
 		goto queue;
 
+	/*
+	 * A writer that is running on a CPU will often leave the lock in
+	 * less time than a sleep/wakeup cycle costs. Spin on the owner the
+	 * way the writer path does and retry lock stealing once the writer
+	 * is gone, instead of queueing behind a nanosecond-scale hold.
+	 */
+	if ((count & RWSEM_WRITER_LOCKED) && rwsem_can_spin_on_owner(sem)) {
+		enum owner_state owner_state;
+
+		/*
+		 * The contention tracepoints let tooling attribute spin
+		 * vs. block outcomes to lock callsites without LOCK_STAT.
+		 */
+		trace_contention_begin(sem, LCB_F_READ | LCB_F_SPIN);
+		preempt_disable();
+		owner_state = rwsem_spin_on_owner(sem);
+		preempt_enable();
+
+		if (owner_state & (OWNER_NULL | OWNER_READER)) {
+			count = atomic_long_read(&sem->count);
+			rcnt = count >> RWSEM_READER_SHIFT;
+			lockevent_inc(rwsem_rlock_spin);
+			trace_contention_end(sem, 0);
+		} else {
+			lockevent_inc(rwsem_rlock_spin_fail);
+			trace_contention_end(sem, -EBUSY);
+		}
+	}
+
 	/*
 	 * Reader optimistic lock stealing.
 	 */
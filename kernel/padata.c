@@ -435,11 +435,23 @@ static void __init padata_mt_helper(struct work_struct *w)
 	spin_lock(&ps->lock);
 
 	while (job->size > 0) {
-		unsigned long start, size, end;
+		unsigned long start, size, end, chunk;
+
+		/*
+		 * Guided self-scheduling: hand out a share of the remaining
+		 * work, capped at the initial chunk size.  Early chunks are
+		 * big and keep dispatch overhead low, while the tail is cut
+		 * finely enough that helpers finishing early can help with
+		 * what is left instead of idling behind a slow thread that
+		 * grabbed a large final chunk.
+		 */
+		chunk = min(ps->chunk_size, job->size / ps->nworks);
+		chunk = max(chunk, job->min_chunk);
+		chunk = roundup(chunk, job->align);
 
 		start = job->start;
 		/* So end is chunk size aligned if enough work remains. */
-		size = roundup(start + 1, ps->chunk_size) - start;
+		size = roundup(start + 1, chunk) - start;
 		size = min(size, job->size);
 		end = start + size;
 
@@ -472,7 +484,7 @@ void __init padata_do_multithreaded(struct padata_mt_job *job)
 	struct padata_work my_work, *pw;
 	struct padata_mt_job_state ps;
 	LIST_HEAD(works);
-	int nworks;
+	int nworks, nid = NUMA_NO_NODE;
 
 	if (job->size == 0)
 		return;
@@ -503,8 +515,15 @@ void __init padata_do_multithreaded(struct padata_mt_job *job)
 	ps.chunk_size = max(ps.chunk_size, job->min_chunk);
 	ps.chunk_size = roundup(ps.chunk_size, job->align);
 
-	list_for_each_entry(pw, &works, pw_list)
-		queue_work(system_unbound_wq, &pw->pw_work);
+	/*
+	 * Spread the helpers over the nodes with CPUs, so that jobs
+	 * touching memory on several nodes are not worked on from a
+	 * single node while the others' memory controllers sit idle.
+	 */
+	list_for_each_entry(pw, &works, pw_list) {
+		nid = next_node_in(nid, node_states[N_CPU]);
+		queue_work_node(nid, system_unbound_wq, &pw->pw_work);
+	}
 
 	/* Use the current thread, which saves starting a workqueue worker. */
 	padata_work_init(&my_work, padata_mt_helper, &ps, PADATA_WORK_ONSTACK);
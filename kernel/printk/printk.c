@@ -2227,6 +2227,22 @@ out:
 	return ret;
 }
 
+/* Flush consoles from the printk() caller's context (default). */
+static bool printk_console_direct = true;
+module_param_named(console_direct, printk_console_direct, bool, 0644);
+MODULE_PARM_DESC(console_direct, "flush consoles from the printk caller; disable to defer flushing to irq work so logging CPUs only pay for the ringbuffer write");
+
+/*
+ * Direct printing must always be used before the per-CPU machinery that
+ * backs the deferred path is ready, and once an oops is underway, when
+ * there may be no irq work coming to flush the consoles.
+ */
+static bool allow_direct_printing(void)
+{
+	return READ_ONCE(printk_console_direct) ||
+	       !printk_percpu_data_ready() || oops_in_progress;
+}
+
 asmlinkage int vprintk_emit(int facility, int level,
 			    const struct dev_printk_info *dev_info,
 			    const char *fmt, va_list args)
@@ -2253,23 +2269,29 @@ asmlinkage int vprintk_emit(int facility, int level,
 
 	/* If called from the scheduler, we can not call up(). */
 	if (!in_sched) {
-		/*
-		 * The caller may be holding system-critical or
-		 * timing-sensitive locks. Disable preemption during
-		 * printing of all remaining records to all consoles so that
-		 * this context can return as soon as possible. Hopefully
-		 * another printk() caller will take over the printing.
-		 */
-		preempt_disable();
-		/*
-		 * Try to acquire and then immediately release the console
-		 * semaphore. The release will print out buffers. With the
-		 * spinning variant, this context tries to take over the
-		 * printing from another printing context.
-		 */
-		if (console_trylock_spinning())
-			console_unlock();
-		preempt_enable();
+		if (allow_direct_printing()) {
+			/*
+			 * The caller may be holding system-critical or
+			 * timing-sensitive locks. Disable preemption during
+			 * printing of all remaining records to all consoles
+			 * so that this context can return as soon as
+			 * possible. Hopefully another printk() caller will
+			 * take over the printing.
+			 */
+			preempt_disable();
+			/*
+			 * Try to acquire and then immediately release the
+			 * console semaphore. The release will print out
+			 * buffers. With the spinning variant, this context
+			 * tries to take over the printing from another
+			 * printing context.
+			 */
+			if (console_trylock_spinning())
+				console_unlock();
+			preempt_enable();
+		} else {
+			defer_console_output();
+		}
 	}
 
 	wake_up_klogd();
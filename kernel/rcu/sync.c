@@ -103,22 +103,7 @@ static void rcu_sync_func(struct rcu_head *rhp)
 	spin_unlock_irqrestore(&rsp->rss_lock, flags);
 }
 
-/**
- * rcu_sync_enter() - Force readers onto slowpath
- * @rsp: Pointer to rcu_sync structure to use for synchronization
- *
- * This function is used by updaters who need readers to make use of
- * a slowpath during the update.  After this function returns, all
- * subsequent calls to rcu_sync_is_idle() will return false, which
- * tells readers to stay off their fastpaths.  A later call to
- * rcu_sync_exit() re-enables reader fastpaths.
- *
- * When called in isolation, rcu_sync_enter() must wait for a grace
- * period, however, closely spaced calls to rcu_sync_enter() can
- * optimize away the grace-period wait via a state machine implemented
- * by rcu_sync_enter(), rcu_sync_exit(), and rcu_sync_func().
- */
-void rcu_sync_enter(struct rcu_sync *rsp)
+static void __rcu_sync_enter(struct rcu_sync *rsp, bool expedited)
 {
 	int gp_state;
 
@@ -146,7 +131,10 @@ void rcu_sync_enter(struct rcu_sync *rsp)
 		 * See the comment above, this simply does the "synchronous"
 		 * call_rcu(rcu_sync_func) which does GP_ENTER -> GP_PASSED.
 		 */
-		synchronize_rcu();
+		if (expedited)
+			synchronize_rcu_expedited();
+		else
+			synchronize_rcu();
 		rcu_sync_func(&rsp->cb_head);
 		/* Not really needed, wait_event() would see GP_PASSED. */
 		return;
@@ -155,6 +143,40 @@ void rcu_sync_enter(struct rcu_sync *rsp)
 	wait_event(rsp->gp_wait, READ_ONCE(rsp->gp_state) >= GP_PASSED);
 }
 
+/**
+ * rcu_sync_enter() - Force readers onto slowpath
+ * @rsp: Pointer to rcu_sync structure to use for synchronization
+ *
+ * This function is used by updaters who need readers to make use of
+ * a slowpath during the update.  After this function returns, all
+ * subsequent calls to rcu_sync_is_idle() will return false, which
+ * tells readers to stay off their fastpaths.  A later call to
+ * rcu_sync_exit() re-enables reader fastpaths.
+ *
+ * When called in isolation, rcu_sync_enter() must wait for a grace
+ * period, however, closely spaced calls to rcu_sync_enter() can
+ * optimize away the grace-period wait via a state machine implemented
+ * by rcu_sync_enter(), rcu_sync_exit(), and rcu_sync_func().
+ */
+void rcu_sync_enter(struct rcu_sync *rsp)
+{
+	__rcu_sync_enter(rsp, false);
+}
+
+/**
+ * rcu_sync_enter_expedited() - Force readers onto slowpath, expedited
+ * @rsp: Pointer to rcu_sync structure to use for synchronization
+ *
+ * Like rcu_sync_enter(), but uses an expedited grace period for the
+ * GP_IDLE transition, trading IPIs to all CPUs for waiting microseconds
+ * instead of milliseconds.  For updaters whose latency matters more
+ * than the system-wide disturbance, e.g. cgroup migration.
+ */
+void rcu_sync_enter_expedited(struct rcu_sync *rsp)
+{
+	__rcu_sync_enter(rsp, true);
+}
+
 /**
  * rcu_sync_exit() - Allow readers back onto fast path after grace period
  * @rsp: Pointer to rcu_sync structure to use for synchronization
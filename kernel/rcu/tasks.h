@@ -73,6 +73,9 @@ struct rcu_tasks_percpu {
  * @barrier_q_count: Number of queues being waited on.
  * @barrier_q_completion: Barrier wait/wakeup mechanism.
  * @barrier_q_seq: Sequence number for barrier operations.
+ * @poll_head: Dummy callback used to drive polled grace periods.
+ * @poll_gp_seq: Furthest-ahead cookie handed out by start-poll.
+ * @poll_queued: True if @poll_head is queued, protected by @cbs_gbl_lock.
  * @name: This flavor's textual name.
  * @kname: This flavor's kthread name.
  */
@@ -104,6 +107,9 @@ struct rcu_tasks {
 	atomic_t barrier_q_count;
 	struct completion barrier_q_completion;
 	unsigned long barrier_q_seq;
+	struct rcu_head poll_head;
+	unsigned long poll_gp_seq;
+	bool poll_queued;
 	char *name;
 	char *kname;
 };
@@ -334,6 +340,78 @@ static void synchronize_rcu_tasks_generic(struct rcu_tasks *rtp)
 	wait_rcu_gp(rtp->call_func);
 }
 
+#ifdef CONFIG_TASKS_TRACE_RCU
+
+// Polled grace-period machinery, currently used only by the tasks-trace
+// flavor.  Cookies are snapshots of ->tasks_gp_seq, so every updater whose
+// cookie precedes a given grace period is satisfied by that same grace
+// period, which allows concurrent updaters to share task scans instead of
+// serializing on them.
+
+// Furnish a grace-period cookie for the specified flavor of Tasks RCU.
+static unsigned long get_state_synchronize_rcu_tasks_generic(struct rcu_tasks *rtp)
+{
+	// Any prior manipulation of RCU-protected data must happen
+	// before the load from ->tasks_gp_seq.
+	smp_mb();  /* ^^^ */
+	return rcu_seq_snap(&rtp->tasks_gp_seq);
+}
+
+// Has the grace period identified by the cookie elapsed?  If so, order
+// against the end of that grace period before returning true.
+static bool poll_state_synchronize_rcu_tasks_generic(struct rcu_tasks *rtp,
+						     unsigned long oldstate)
+{
+	if (rcu_seq_done(&rtp->tasks_gp_seq, oldstate)) {
+		smp_mb(); /* Ensure GP ends before subsequent accesses. */
+		return true;
+	}
+	return false;
+}
+
+// Dummy callback that requeues itself until the furthest-ahead cookie
+// handed out by start_poll_synchronize_rcu_tasks_generic() has been
+// satisfied, then goes idle.  This is what keeps grace periods coming
+// for pollers when no other callbacks are queued.
+static void rcu_tasks_poll_gp_cb(struct rcu_head *rhp)
+{
+	unsigned long flags;
+	bool requeue;
+	struct rcu_tasks *rtp = container_of(rhp, struct rcu_tasks, poll_head);
+
+	raw_spin_lock_irqsave(&rtp->cbs_gbl_lock, flags);
+	requeue = !rcu_seq_done(&rtp->tasks_gp_seq, rtp->poll_gp_seq);
+	if (!requeue)
+		rtp->poll_queued = false;
+	raw_spin_unlock_irqrestore(&rtp->cbs_gbl_lock, flags);
+	if (requeue)
+		call_rcu_tasks_generic(rhp, rcu_tasks_poll_gp_cb, rtp);
+}
+
+// Snapshot the grace-period sequence number and ensure that the
+// corresponding grace period actually gets started, without making the
+// caller wait for it.
+static unsigned long start_poll_synchronize_rcu_tasks_generic(struct rcu_tasks *rtp)
+{
+	unsigned long flags;
+	bool needcb = false;
+	unsigned long s = get_state_synchronize_rcu_tasks_generic(rtp);
+
+	raw_spin_lock_irqsave(&rtp->cbs_gbl_lock, flags);
+	if (ULONG_CMP_LT(rtp->poll_gp_seq, s))
+		rtp->poll_gp_seq = s;
+	if (!rtp->poll_queued) {
+		rtp->poll_queued = true;
+		needcb = true;
+	}
+	raw_spin_unlock_irqrestore(&rtp->cbs_gbl_lock, flags);
+	if (needcb)
+		call_rcu_tasks_generic(&rtp->poll_head, rcu_tasks_poll_gp_cb, rtp);
+	return s;
+}
+
+#endif /* #ifdef CONFIG_TASKS_TRACE_RCU */
+
 // RCU callback function for rcu_barrier_tasks_generic().
 static void rcu_barrier_tasks_generic_cb(struct rcu_head *rhp)
 {
@@ -1619,6 +1697,78 @@ void synchronize_rcu_tasks_trace(void)
 }
 EXPORT_SYMBOL_GPL(synchronize_rcu_tasks_trace);
 
+/**
+ * get_state_synchronize_rcu_tasks_trace - Snapshot RCU-tasks-trace state
+ *
+ * Returns a cookie that is used by a later call to
+ * cond_synchronize_rcu_tasks_trace() or poll_state_synchronize_rcu_tasks_trace()
+ * to determine whether or not a full trace rcu-tasks grace period has
+ * elapsed in the meantime.
+ */
+unsigned long get_state_synchronize_rcu_tasks_trace(void)
+{
+	return get_state_synchronize_rcu_tasks_generic(&rcu_tasks_trace);
+}
+EXPORT_SYMBOL_GPL(get_state_synchronize_rcu_tasks_trace);
+
+/**
+ * start_poll_synchronize_rcu_tasks_trace - Snapshot and start a grace period
+ *
+ * Returns a cookie that is used by a later call to
+ * cond_synchronize_rcu_tasks_trace() or poll_state_synchronize_rcu_tasks_trace()
+ * to determine whether or not a full trace rcu-tasks grace period has
+ * elapsed in the meantime.  If the needed grace period is not already
+ * slated to start, notifies the grace-period kthread of the need for it.
+ * Unlike synchronize_rcu_tasks_trace(), the caller does not wait, which
+ * lets updaters that can defer their cleanup share a single task scan
+ * rather than serializing on one apiece.
+ */
+unsigned long start_poll_synchronize_rcu_tasks_trace(void)
+{
+	return start_poll_synchronize_rcu_tasks_generic(&rcu_tasks_trace);
+}
+EXPORT_SYMBOL_GPL(start_poll_synchronize_rcu_tasks_trace);
+
+/**
+ * poll_state_synchronize_rcu_tasks_trace - Has the grace period elapsed?
+ *
+ * @oldstate: value from get_state_synchronize_rcu_tasks_trace() or
+ *	      start_poll_synchronize_rcu_tasks_trace()
+ *
+ * If a full trace rcu-tasks grace period has elapsed since the earlier
+ * call from which @oldstate was obtained, return @true, otherwise return
+ * @false.  If @false is returned, it is the caller's responsibility to
+ * invoke this function later on until it does return @true, or to pass
+ * @oldstate to cond_synchronize_rcu_tasks_trace().
+ *
+ * This function provides the same memory-ordering guarantees that would
+ * be provided by a synchronize_rcu_tasks_trace() that was invoked at the
+ * call to the function that provided @oldstate, and that returned at the
+ * end of this function.
+ */
+bool poll_state_synchronize_rcu_tasks_trace(unsigned long oldstate)
+{
+	return poll_state_synchronize_rcu_tasks_generic(&rcu_tasks_trace, oldstate);
+}
+EXPORT_SYMBOL_GPL(poll_state_synchronize_rcu_tasks_trace);
+
+/**
+ * cond_synchronize_rcu_tasks_trace - Conditionally wait for a grace period
+ *
+ * @oldstate: value from get_state_synchronize_rcu_tasks_trace() or
+ *	      start_poll_synchronize_rcu_tasks_trace()
+ *
+ * If a full trace rcu-tasks grace period has elapsed since the earlier
+ * call from which @oldstate was obtained, just return.  Otherwise, invoke
+ * synchronize_rcu_tasks_trace() to wait for a full grace period.
+ */
+void cond_synchronize_rcu_tasks_trace(unsigned long oldstate)
+{
+	if (!poll_state_synchronize_rcu_tasks_trace(oldstate))
+		synchronize_rcu_tasks_trace();
+}
+EXPORT_SYMBOL_GPL(cond_synchronize_rcu_tasks_trace);
+
 /**
  * rcu_barrier_tasks_trace - Wait for in-flight call_rcu_tasks_trace() callbacks.
  *
@@ -1422,6 +1422,18 @@ bool should_numa_migrate_memory(struct task_struct *p, struct page * page,
 	this_cpupid = cpu_pid_to_cpupid(dst_cpu, current->pid);
 	last_cpupid = page_cpupid_xchg_last(page, this_cpupid);
 
+	/*
+	 * A page sitting on a memory-only node (a slow tier: CXL, PMEM)
+	 * can never be node-local to the task, so the shared/private and
+	 * frequency heuristics below - which decide between CPU-bearing
+	 * nodes - do not apply.  The hint fault itself is the hotness
+	 * signal: promote the page towards the faulting CPU right away,
+	 * and let reclaim-driven demotion push it back down if it goes
+	 * cold again.
+	 */
+	if (!node_state(src_nid, N_CPU))
+		return true;
+
 	/*
 	 * Allow first faults or private faults to migrate immediately early in
 	 * the lifetime of a task. The magic number 4 is based on waiting for
@@ -4725,6 +4737,8 @@ static inline u64 sched_cfs_bandwidth_slice(void)
 	return (u64)sysctl_sched_cfs_bandwidth_slice * NSEC_PER_USEC;
 }
 
+static void start_cfs_advance_bandwidth(struct cfs_bandwidth *cfs_b);
+
 /*
  * Replenish runtime according to assigned quota. We use sched_clock_cpu
  * directly instead of rq->clock to avoid adding additional synchronization
@@ -4739,7 +4753,13 @@ void __refill_cfs_bandwidth_runtime(struct cfs_bandwidth *cfs_b)
 	if (unlikely(cfs_b->quota == RUNTIME_INF))
 		return;
 
-	cfs_b->runtime += cfs_b->quota;
+	/*
+	 * Runtime handed out early by the advance timer was borrowed from
+	 * this refill; repay it so that a period never grants more than
+	 * quota + burst in total.
+	 */
+	cfs_b->runtime += cfs_b->quota - min(cfs_b->runtime_advance, cfs_b->quota);
+	cfs_b->runtime_advance = 0;
 	runtime = cfs_b->runtime_snap - cfs_b->runtime;
 	if (runtime > 0) {
 		cfs_b->burst_time += runtime;
@@ -4906,6 +4926,12 @@ static bool throttle_cfs_rq(struct cfs_rq *cfs_rq)
 	} else {
 		list_add_tail_rcu(&cfs_rq->throttled_list,
 				  &cfs_b->throttled_cfs_rq);
+		/*
+		 * Instead of stalling until the refresh, trickle out what is
+		 * left of next period's quota in bandwidth-slice sized
+		 * instalments.
+		 */
+		start_cfs_advance_bandwidth(cfs_b);
 	}
 	raw_spin_unlock(&cfs_b->lock);
 
@@ -5218,6 +5244,79 @@ static void start_cfs_slack_bandwidth(struct cfs_bandwidth *cfs_b)
 			HRTIMER_MODE_REL);
 }
 
+/*
+ * A throttled group otherwise stalls until the period refresh, which can be
+ * most of a period away.  The advance timer instead pays out the upcoming
+ * refill early, one period-proportional instalment per bandwidth slice, so a
+ * group at its limit degrades to a proportional slowdown rather than a hard
+ * stall.  Everything delivered early is repaid at the next refill, keeping
+ * the per-period budget unchanged.
+ *
+ * Requires cfs_b->lock
+ */
+static void start_cfs_advance_bandwidth(struct cfs_bandwidth *cfs_b)
+{
+	if (cfs_b->quota == RUNTIME_INF)
+		return;
+
+	/* the refresh is close enough to do the unthrottling itself */
+	if (runtime_refresh_within(cfs_b, sched_cfs_bandwidth_slice()))
+		return;
+
+	/* next period's quota is exhausted; wait for the refresh */
+	if (cfs_b->runtime_advance >= cfs_b->quota)
+		return;
+
+	if (cfs_b->advance_started)
+		return;
+	cfs_b->advance_started = true;
+
+	hrtimer_start(&cfs_b->advance_timer,
+			ns_to_ktime(sched_cfs_bandwidth_slice()),
+			HRTIMER_MODE_REL);
+}
+
+/* returns 0 when the timer should not be re-armed */
+static int do_sched_cfs_advance_timer(struct cfs_bandwidth *cfs_b)
+{
+	unsigned long flags;
+	int restart;
+	u64 amount;
+
+	raw_spin_lock_irqsave(&cfs_b->lock, flags);
+	if (cfs_b->quota == RUNTIME_INF ||
+	    list_empty(&cfs_b->throttled_cfs_rq) ||
+	    cfs_b->runtime_advance >= cfs_b->quota ||
+	    runtime_refresh_within(cfs_b, min_bandwidth_expiration)) {
+		cfs_b->advance_started = false;
+		raw_spin_unlock_irqrestore(&cfs_b->lock, flags);
+		return 0;
+	}
+
+	/* one slice's worth of the next period, capped at the full refill */
+	amount = mul_u64_u64_div_u64(cfs_b->quota, sched_cfs_bandwidth_slice(),
+				     ktime_to_ns(cfs_b->period));
+	amount = min(amount, cfs_b->quota - cfs_b->runtime_advance);
+
+	cfs_b->runtime_advance += amount;
+	cfs_b->runtime += amount;
+	/* advanced runtime is granted, not burst; keep the stats honest */
+	cfs_b->runtime_snap += amount;
+	raw_spin_unlock_irqrestore(&cfs_b->lock, flags);
+
+	if (amount)
+		distribute_cfs_runtime(cfs_b);
+
+	raw_spin_lock_irqsave(&cfs_b->lock, flags);
+	restart = !list_empty(&cfs_b->throttled_cfs_rq) &&
+		  cfs_b->runtime_advance < cfs_b->quota;
+	if (!restart)
+		cfs_b->advance_started = false;
+	raw_spin_unlock_irqrestore(&cfs_b->lock, flags);
+
+	return restart;
+}
+
 /* we know any runtime found here is valid as update_curr() precedes return */
 static void __return_cfs_rq_runtime(struct cfs_rq *cfs_rq)
 {
@@ -5352,6 +5451,18 @@ static enum hrtimer_restart sched_cfs_slack_timer(struct hrtimer *timer)
 	return HRTIMER_NORESTART;
 }
 
+static enum hrtimer_restart sched_cfs_advance_timer(struct hrtimer *timer)
+{
+	struct cfs_bandwidth *cfs_b =
+		container_of(timer, struct cfs_bandwidth, advance_timer);
+
+	if (!do_sched_cfs_advance_timer(cfs_b))
+		return HRTIMER_NORESTART;
+
+	hrtimer_forward_now(timer, ns_to_ktime(sched_cfs_bandwidth_slice()));
+	return HRTIMER_RESTART;
+}
+
 extern const u64 max_cfs_quota_period;
 
 static enum hrtimer_restart sched_cfs_period_timer(struct hrtimer *timer)
@@ -5423,6 +5534,10 @@ void init_cfs_bandwidth(struct cfs_bandwidth *cfs_b)
 	hrtimer_init(&cfs_b->slack_timer, CLOCK_MONOTONIC, HRTIMER_MODE_REL);
 	cfs_b->slack_timer.function = sched_cfs_slack_timer;
 	cfs_b->slack_started = false;
+	hrtimer_init(&cfs_b->advance_timer, CLOCK_MONOTONIC, HRTIMER_MODE_REL);
+	cfs_b->advance_timer.function = sched_cfs_advance_timer;
+	cfs_b->advance_started = false;
+	cfs_b->runtime_advance = 0;
 }
 
 static void init_cfs_rq_runtime(struct cfs_rq *cfs_rq)
@@ -5451,6 +5566,7 @@ static void destroy_cfs_bandwidth(struct cfs_bandwidth *cfs_b)
 
 	hrtimer_cancel(&cfs_b->period_timer);
 	hrtimer_cancel(&cfs_b->slack_timer);
+	hrtimer_cancel(&cfs_b->advance_timer);
 }
 
 /*
@@ -6304,6 +6420,25 @@ static int select_idle_smt(struct task_struct *p, struct sched_domain *sd, int t
 	return -1;
 }
 
+/*
+ * Does @cpu share its core with at least one busy SMT sibling?  Used to
+ * pack latency-tolerant tasks onto partially busy cores, keeping fully
+ * idle cores available for latency-sensitive wakeups.
+ */
+static bool cpu_smt_sibling_busy(int cpu)
+{
+	int sibling;
+
+	for_each_cpu(sibling, cpu_smt_mask(cpu)) {
+		if (sibling == cpu)
+			continue;
+		if (!available_idle_cpu(sibling))
+			return true;
+	}
+
+	return false;
+}
+
 #else /* CONFIG_SCHED_SMT */
 
 static inline void set_idle_cores(int cpu, int val)
@@ -6325,6 +6460,11 @@ static inline int select_idle_smt(struct task_struct *p, struct sched_domain *sd
 	return -1;
 }
 
+static inline bool cpu_smt_sibling_busy(int cpu)
+{
+	return false;
+}
+
 #endif /* CONFIG_SCHED_SMT */
 
 /*
@@ -6332,10 +6472,33 @@ static inline int select_idle_smt(struct task_struct *p, struct sched_domain *sd
  * comparing the average scan cost (tracked in sd->avg_scan_cost) against the
  * average idle time for this rq (as found in rq->avg_idle).
  */
+/*
+ * Maintain the LLC-wide mask of CPUs sitting in the idle loop.  Called on
+ * idle entry and exit only, so the cost is one (uncontended in the common
+ * case) atomic per idle transition rather than anything on the wakeup path.
+ */
+void update_idle_cpumask(int cpu, bool idle)
+{
+	struct sched_domain_shared *sds;
+
+	rcu_read_lock();
+	sds = rcu_dereference(per_cpu(sd_llc_shared, cpu));
+	if (sds &&
+	    cpumask_test_cpu(cpu, &sds->idle_cpus_span) != idle) {
+		if (idle)
+			cpumask_set_cpu(cpu, &sds->idle_cpus_span);
+		else
+			cpumask_clear_cpu(cpu, &sds->idle_cpus_span);
+	}
+	rcu_read_unlock();
+}
+
 static int select_idle_cpu(struct task_struct *p, struct sched_domain *sd, bool has_idle_core, int target)
 {
 	struct cpumask *cpus = this_cpu_cpumask_var_ptr(select_idle_mask);
 	int i, cpu, idle_cpu = -1, nr = INT_MAX;
+	bool pack = sched_smt_active() && p->latency_nice > 0;
+	int pack_fallback = -1;
 	struct rq *this_rq = this_rq();
 	int this = smp_processor_id();
 	struct sched_domain *this_sd;
@@ -6347,6 +6510,25 @@ static int select_idle_cpu(struct task_struct *p, struct sched_domain *sd, bool
 
 	cpumask_and(cpus, sched_domain_span(sd), p->cpus_ptr);
 
+	/*
+	 * Consult the LLC idle mask first: if it has a usable bit, wakeup
+	 * placement is a find-bit plus one recheck instead of a linear
+	 * scan.  The mask is maintained from the idle path and can be
+	 * stale, so every candidate is re-verified and an empty or fully
+	 * stale mask just falls through to the bounded scan below.  Core
+	 * search keeps the full scan as it needs whole-core state.
+	 */
+	if (!has_idle_core && !pack && sd->shared) {
+		for_each_cpu_wrap(cpu, &sd->shared->idle_cpus_span, target + 1) {
+			if (!cpumask_test_cpu(cpu, cpus))
+				continue;
+			idle_cpu = __select_idle_cpu(cpu, p);
+			if ((unsigned int)idle_cpu < nr_cpumask_bits)
+				return idle_cpu;
+		}
+		idle_cpu = -1;
+	}
+
 	if (sched_feat(SIS_PROP) && !has_idle_core) {
 		u64 avg_cost, avg_idle, span_avg;
 		unsigned long now = jiffies;
@@ -6383,13 +6565,30 @@ static int select_idle_cpu(struct task_struct *p, struct sched_domain *sd, bool
 
 		} else {
 			if (!--nr)
-				return -1;
+				return pack_fallback;
 			idle_cpu = __select_idle_cpu(cpu, p);
-			if ((unsigned int)idle_cpu < nr_cpumask_bits)
+			if ((unsigned int)idle_cpu < nr_cpumask_bits) {
+				/*
+				 * A latency-tolerant task prefers an idle
+				 * sibling of a busy core, so that fully idle
+				 * cores stay available for latency-sensitive
+				 * wakeups.  Remember the first idle CPU on a
+				 * free core in case no such sibling exists.
+				 */
+				if (pack && !cpu_smt_sibling_busy(idle_cpu)) {
+					if (pack_fallback < 0)
+						pack_fallback = idle_cpu;
+					idle_cpu = -1;
+					continue;
+				}
 				break;
+			}
 		}
 	}
 
+	if (idle_cpu < 0)
+		idle_cpu = pack_fallback;
+
 	if (has_idle_core)
 		set_idle_cores(target, false);
 
@@ -7038,6 +7237,19 @@ static unsigned long wakeup_gran(struct sched_entity *se)
 	 * This is especially important for buddies when the leftmost
 	 * task is higher priority than the buddy.
 	 */
+
+	/*
+	 * Scale the granularity by the waking task's latency_nice: a
+	 * latency-sensitive wakee (latency_nice < 0) needs to overcome a
+	 * smaller gap to preempt, down to none at MIN_LATENCY_NICE, while
+	 * a latency-tolerant one has to build up a bigger lag first.  The
+	 * CPU bandwidth distribution is still governed solely by the
+	 * weights; this only moves the preemption point.
+	 */
+	if (entity_is_task(se))
+		gran += (long)gran * task_of(se)->latency_nice /
+			(MAX_LATENCY_NICE + 1);
+
 	return calc_delta_fair(gran, se);
 }
 
@@ -7926,8 +8138,12 @@ static int detach_tasks(struct lb_env *env)
 		p = list_last_entry(tasks, struct task_struct, se.group_node);
 
 		env->loop++;
-		/* We've more or less seen every task there is, call it quits */
-		if (env->loop > env->loop_max)
+		/*
+		 * We've more or less seen every task there is, call it quits
+		 * unless we haven't found any movable task yet.
+		 */
+		if (env->loop > env->loop_max &&
+		    !(env->flags & LBF_ALL_PINNED))
 			break;
 
 		/* take a breather every nr_migrate tasks */
@@ -275,6 +275,7 @@ static void do_idle(void)
 
 	__current_set_polling();
 	tick_nohz_idle_enter();
+	update_idle_cpumask(cpu, true);
 
 	while (!need_resched()) {
 		rmb();
@@ -314,6 +315,7 @@ static void do_idle(void)
 	 */
 	preempt_set_need_resched();
 	tick_nohz_idle_exit();
+	update_idle_cpumask(cpu, false);
 	__current_clr_polling();
 
 	/*
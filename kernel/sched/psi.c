@@ -160,7 +160,7 @@ __setup("psi=", setup_psi);
 #define EXP_300s	2034		/* 1/exp(2s/300s) */
 
 /* PSI trigger definitions */
-#define WINDOW_MIN_US 500000	/* Min window size is 500ms */
+#define WINDOW_MIN_US 50000	/* Min window size is 50ms */
 #define WINDOW_MAX_US 10000000	/* Max window size is 10s */
 #define UPDATES_PER_WINDOW 10	/* 10 updates per window */
 
@@ -180,9 +180,13 @@ static void poll_timer_fn(struct timer_list *t);
 static void group_init(struct psi_group *group)
 {
 	int cpu;
+	int a;
 
 	for_each_possible_cpu(cpu)
 		seqcount_init(&per_cpu_ptr(group->pcpu, cpu)->seq);
+	/* Have the first collection visit every CPU */
+	for (a = 0; a < NR_PSI_AGGREGATORS; a++)
+		cpumask_setall(&group->changed_cpus[a]);
 	group->avg_last_update = sched_clock();
 	group->avg_next_update = group->avg_last_update + psi_period;
 	INIT_DELAYED_WORK(&group->avgs_work, psi_avgs_work);
@@ -282,6 +286,14 @@ static void get_recent_times(struct psi_group *group, int cpu,
 		if (delta)
 			*pchanged_states |= (1 << s);
 	}
+
+	/*
+	 * A CPU sitting in a stall state keeps accruing time without
+	 * generating further state changes; keep it marked for this
+	 * aggregator until it has gone quiescent.
+	 */
+	if (state_mask)
+		cpumask_set_cpu(cpu, &group->changed_cpus[aggregator]);
 }
 
 static void calc_avgs(unsigned long avg[3], int missed_periods,
@@ -321,12 +333,19 @@ static void collect_percpu_times(struct psi_group *group,
 	 * For averaging, each CPU is weighted by its non-idle time in
 	 * the sampling period. This eliminates artifacts from uneven
 	 * loading, or even entirely idle CPUs.
+	 *
+	 * CPUs with no task state changes since this aggregator last
+	 * ran have nothing to contribute and are skipped outright; the
+	 * deltas are against cumulative counters, so nothing is lost if
+	 * a change vs. clear race leaves a bit set for an extra pass.
 	 */
-	for_each_possible_cpu(cpu) {
+	for_each_cpu_and(cpu, &group->changed_cpus[aggregator],
+			 cpu_possible_mask) {
 		u32 times[NR_PSI_STATES];
 		u32 nonidle;
 		u32 cpu_changed_states;
 
+		cpumask_clear_cpu(cpu, &group->changed_cpus[aggregator]);
 		get_recent_times(group, cpu, aggregator, times,
 				&cpu_changed_states);
 		changed_states |= cpu_changed_states;
@@ -750,6 +769,15 @@ static void psi_group_change(struct psi_group *group, int cpu,
 
 	write_seqcount_end(&groupc->seq);
 
+	/*
+	 * Flag this CPU for the aggregators; test first to keep the
+	 * common repeated-change case free of atomics.
+	 */
+	for (t = 0; t < NR_PSI_AGGREGATORS; t++) {
+		if (!cpumask_test_cpu(cpu, &group->changed_cpus[t]))
+			cpumask_set_cpu(cpu, &group->changed_cpus[t]);
+	}
+
 	if (state_mask & group->poll_states)
 		psi_schedule_poll_work(group, 1);
 
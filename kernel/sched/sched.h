@@ -361,13 +361,17 @@ struct cfs_bandwidth {
 	u64			runtime;
 	u64			burst;
 	u64			runtime_snap;
+	/* Runtime delivered early by the advance timer, repaid at refill */
+	u64			runtime_advance;
 	s64			hierarchical_quota;
 
 	u8			idle;
 	u8			period_active;
 	u8			slack_started;
+	u8			advance_started;
 	struct hrtimer		period_timer;
 	struct hrtimer		slack_timer;
+	struct hrtimer		advance_timer;
 	struct list_head	throttled_cfs_rq;
 
 	/* Statistics: */
@@ -2754,6 +2758,12 @@ extern void nohz_run_idle_balance(int cpu);
 static inline void nohz_run_idle_balance(int cpu) { }
 #endif
 
+#ifdef CONFIG_SMP
+extern void update_idle_cpumask(int cpu, bool idle);
+#else
+static inline void update_idle_cpumask(int cpu, bool idle) { }
+#endif
+
 #ifdef CONFIG_IRQ_TIME_ACCOUNTING
 struct irqtime {
 	u64			total;
@@ -1037,6 +1037,56 @@ __mod_timer(struct timer_list *timer, unsigned long expires, unsigned int option
 		if (options & MOD_TIMER_REDUCE && diff <= 0)
 			return 1;
 
+		/*
+		 * If the new expiry lands in the bucket the timer is already
+		 * queued in, then the tick at which it fires does not change
+		 * and the timer can be left alone without taking the base
+		 * lock.  High-rate re-arming (networking again) hits this
+		 * case most of the time.
+		 *
+		 * The flags and clk snapshots are not atomic, and
+		 * detach_timer() leaves the old array bits in the flags
+		 * word, so a flags value from before an expiry combined
+		 * with a clk value from after it can alias the same bucket
+		 * index one wheel lap ahead.  Two checks close that off:
+		 * the lap bound on @diff rejects any match whose firing
+		 * tick could differ from the queued one (equal index plus
+		 * an expiry shift smaller than a level lap pins the match
+		 * to the same lap), and the re-read of timer_pending(),
+		 * ordered after the clk read, drops a timer that expired
+		 * meanwhile into the locked path for a proper re-arm.  Any
+		 * mismatch only falls back to the locked path below.
+		 *
+		 * Note that timer->expires is deliberately left stale; the
+		 * wheel position alone determines the firing tick, and the
+		 * stored value stays within one bucket granularity of it.
+		 * A later MOD_TIMER_REDUCE comparing against the stale
+		 * value can at worst keep a firing tick one granularity
+		 * unit late, which is within the wheel's rounding anyway.
+		 * Direct readers of ->expires see the same bounded skew.
+		 */
+		if (!(options & MOD_TIMER_REDUCE)) {
+			u32 tf = READ_ONCE(timer->flags);
+
+			if (!(tf & TIMER_MIGRATING)) {
+				unsigned long gran, lap;
+
+				clk = READ_ONCE(get_timer_base(tf)->clk);
+				idx = calc_wheel_index(expires, clk, &bucket_expiry);
+				gran = LVL_GRAN(idx / LVL_SIZE);
+				lap = LVL_SIZE * gran;
+
+				/* Order the pending re-check after the clk read */
+				smp_rmb();
+				if (idx == ((tf & TIMER_ARRAYMASK) >> TIMER_ARRAYSHIFT) &&
+				    -diff < (long)(lap - gran) &&
+				    diff < (long)(lap - gran) &&
+				    timer_pending(timer))
+					return 1;
+				idx = UINT_MAX;
+			}
+		}
+
 		/*
 		 * We lock timer base and calculate the bucket index right
 		 * here. If the timer ends up in the same bucket, then we
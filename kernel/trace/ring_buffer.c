@@ -331,6 +331,7 @@ struct buffer_page {
 	unsigned	 read;		/* index for next read */
 	local_t		 entries;	/* entries on this page */
 	unsigned long	 real_end;	/* real end of data */
+	unsigned	 id;		/* ID for external mapping */
 	struct buffer_data_page *page;	/* Actual data page */
 };
 
@@ -533,6 +534,11 @@ struct ring_buffer_per_cpu {
 	struct work_struct		update_pages_work;
 	struct completion		update_done;
 
+	/* pages are mapped to user space, see ring_buffer_map() */
+	unsigned int			mapped;
+	unsigned long			*subbuf_ids;	/* ID to subbuf addr */
+	struct trace_buffer_meta	*meta_page;
+
 	struct rb_irq_work		irq_work;
 };
 
@@ -2117,7 +2123,8 @@ int ring_buffer_resize(struct trace_buffer *buffer, unsigned long size,
 		 */
 		for_each_buffer_cpu(buffer, cpu) {
 			cpu_buffer = buffer->buffers[cpu];
-			if (atomic_read(&cpu_buffer->resize_disabled)) {
+			if (atomic_read(&cpu_buffer->resize_disabled) ||
+			    cpu_buffer->mapped) {
 				err = -EBUSY;
 				goto out_err_unlock;
 			}
@@ -2191,7 +2198,8 @@ int ring_buffer_resize(struct trace_buffer *buffer, unsigned long size,
 		 * manipulating the ring buffer and is expecting a sane state while
 		 * this is true.
 		 */
-		if (atomic_read(&cpu_buffer->resize_disabled)) {
+		if (atomic_read(&cpu_buffer->resize_disabled) ||
+		    cpu_buffer->mapped) {
 			err = -EBUSY;
 			goto out_err_unlock;
 		}
@@ -5400,6 +5408,12 @@ int ring_buffer_swap_cpu(struct trace_buffer *buffer_a,
 	if (atomic_read(&cpu_buffer_b->record_disabled))
 		goto out;
 
+	ret = -EBUSY;
+
+	/* User mappings are glued to the pages of their cpu_buffer */
+	if (cpu_buffer_a->mapped || cpu_buffer_b->mapped)
+		goto out;
+
 	/*
 	 * We can't do a synchronize_rcu here because this
 	 * function can be called in atomic context.
@@ -5607,10 +5621,13 @@ int ring_buffer_read_page(struct trace_buffer *buffer,
 	 * if len is not big enough to read the rest of the page or
 	 * a writer is still on the page, then
 	 * we must copy the data from the page to the buffer.
-	 * Otherwise, we can simply swap the page with the one passed in.
+	 * Otherwise, we can simply swap the page with the one passed in,
+	 * unless the buffer is mapped to user space, in which case all
+	 * its pages must stay put.
 	 */
 	if (read || (len < (commit - read)) ||
-	    cpu_buffer->reader_page == cpu_buffer->commit_page) {
+	    cpu_buffer->reader_page == cpu_buffer->commit_page ||
+	    cpu_buffer->mapped) {
 		struct buffer_data_page *rpage = cpu_buffer->reader_page->page;
 		unsigned int rpos = read;
 		unsigned int pos = 0;
@@ -5719,6 +5736,239 @@ int ring_buffer_read_page(struct trace_buffer *buffer,
 }
 EXPORT_SYMBOL_GPL(ring_buffer_read_page);
 
+static void rb_update_meta_page(struct ring_buffer_per_cpu *cpu_buffer)
+{
+	struct trace_buffer_meta *meta = cpu_buffer->meta_page;
+
+	if (!meta)
+		return;
+
+	meta->reader_id = cpu_buffer->reader_page->id;
+	meta->reader_read = cpu_buffer->reader_page->read;
+	meta->reader_commit = rb_page_commit(cpu_buffer->reader_page);
+	meta->reader_lost_events = cpu_buffer->lost_events;
+
+	meta->entries = local_read(&cpu_buffer->entries);
+	meta->overrun = local_read(&cpu_buffer->overrun);
+	meta->read = cpu_buffer->read;
+}
+
+static void rb_setup_ids_meta_page(struct ring_buffer_per_cpu *cpu_buffer,
+				   unsigned long *subbuf_ids)
+{
+	struct trace_buffer_meta *meta = cpu_buffer->meta_page;
+	struct buffer_page *bpage;
+	struct list_head *p;
+	unsigned int id = 0;
+
+	/*
+	 * The reader page always gets id 0, the rest of the ring follows in
+	 * list order.  The ids stick to their pages: when the reader swaps
+	 * its page into the ring, the ids travel with the pages and the
+	 * user space mapping stays valid.
+	 */
+	cpu_buffer->reader_page->id = id;
+	subbuf_ids[id++] = (unsigned long)cpu_buffer->reader_page->page;
+
+	p = rb_list_head(cpu_buffer->pages);
+	do {
+		bpage = list_entry(p, struct buffer_page, list);
+		bpage->id = id;
+		subbuf_ids[id++] = (unsigned long)bpage->page;
+		p = rb_list_head(p->next);
+	} while (p != rb_list_head(cpu_buffer->pages));
+
+	cpu_buffer->subbuf_ids = subbuf_ids;
+
+	meta->meta_page_size = PAGE_SIZE;
+	meta->subbuf_size = PAGE_SIZE;
+	meta->nr_subbufs = id;
+
+	rb_update_meta_page(cpu_buffer);
+}
+
+/**
+ * ring_buffer_map - map a per-CPU ring buffer into user space
+ * @buffer: The ring buffer to map
+ * @cpu: The per CPU buffer to map
+ * @vma: The user vma to map into, starting with the meta page
+ *
+ * The vma must span the meta page, the reader page and every data page of
+ * the ring, in that order, and must be read-only.  While a mapping exists
+ * the pages of @cpu's buffer are pinned in place: resizing, snapshotting
+ * and the page-stealing read path are all disabled for it.
+ */
+int ring_buffer_map(struct trace_buffer *buffer, int cpu,
+		    struct vm_area_struct *vma)
+{
+	struct ring_buffer_per_cpu *cpu_buffer;
+	unsigned long flags, *subbuf_ids;
+	unsigned long addr = vma->vm_start;
+	unsigned int i, nr_subbufs;
+	int err = 0;
+
+	if (!cpumask_test_cpu(cpu, buffer->cpumask))
+		return -EINVAL;
+
+	if (vma->vm_pgoff || (vma->vm_flags & VM_WRITE))
+		return -EINVAL;
+
+	cpu_buffer = buffer->buffers[cpu];
+	nr_subbufs = cpu_buffer->nr_pages + 1;
+
+	/* Meta page + reader page + the rest of the ring */
+	if (vma_pages(vma) != nr_subbufs + 1)
+		return -EINVAL;
+
+	mutex_lock(&buffer->mutex);
+
+	if (cpu_buffer->mapped) {
+		err = -EBUSY;
+		goto unlock;
+	}
+
+	cpu_buffer->meta_page = (struct trace_buffer_meta *)
+		get_zeroed_page(GFP_KERNEL);
+	if (!cpu_buffer->meta_page) {
+		err = -ENOMEM;
+		goto unlock;
+	}
+
+	subbuf_ids = kcalloc(nr_subbufs, sizeof(*subbuf_ids), GFP_KERNEL);
+	if (!subbuf_ids) {
+		free_page((unsigned long)cpu_buffer->meta_page);
+		cpu_buffer->meta_page = NULL;
+		err = -ENOMEM;
+		goto unlock;
+	}
+
+	/*
+	 * Lock out readers while the page ids are handed out, and lock out
+	 * rb_get_reader_page() until the mapping is fully set up.
+	 */
+	raw_spin_lock_irqsave(&cpu_buffer->reader_lock, flags);
+	rb_setup_ids_meta_page(cpu_buffer, subbuf_ids);
+	cpu_buffer->mapped = 1;
+	raw_spin_unlock_irqrestore(&cpu_buffer->reader_lock, flags);
+
+	err = vm_insert_page(vma, addr, virt_to_page(cpu_buffer->meta_page));
+	addr += PAGE_SIZE;
+
+	for (i = 0; !err && i < nr_subbufs; i++) {
+		err = vm_insert_page(vma, addr,
+				     virt_to_page((void *)subbuf_ids[i]));
+		addr += PAGE_SIZE;
+	}
+
+	if (err) {
+		/* The caller tears down the vma, only our state is undone */
+		void *meta_page = cpu_buffer->meta_page;
+
+		raw_spin_lock_irqsave(&cpu_buffer->reader_lock, flags);
+		cpu_buffer->mapped = 0;
+		cpu_buffer->meta_page = NULL;
+		cpu_buffer->subbuf_ids = NULL;
+		raw_spin_unlock_irqrestore(&cpu_buffer->reader_lock, flags);
+		kfree(subbuf_ids);
+		free_page((unsigned long)meta_page);
+	}
+
+ unlock:
+	mutex_unlock(&buffer->mutex);
+
+	return err;
+}
+
+/**
+ * ring_buffer_unmap - tear down the user space mapping of a per-CPU buffer
+ * @buffer: The ring buffer the mapping was made on
+ * @cpu: The per CPU buffer that was mapped
+ *
+ * The pages themselves stay alive for as long as the vma holds references
+ * on them; only the buffer side of the mapping is undone here.
+ */
+int ring_buffer_unmap(struct trace_buffer *buffer, int cpu)
+{
+	struct ring_buffer_per_cpu *cpu_buffer;
+	unsigned long flags, *subbuf_ids;
+	void *meta_page;
+	int err = 0;
+
+	if (!cpumask_test_cpu(cpu, buffer->cpumask))
+		return -EINVAL;
+
+	cpu_buffer = buffer->buffers[cpu];
+
+	mutex_lock(&buffer->mutex);
+
+	if (!cpu_buffer->mapped) {
+		err = -ENODEV;
+		goto unlock;
+	}
+
+	raw_spin_lock_irqsave(&cpu_buffer->reader_lock, flags);
+	cpu_buffer->mapped = 0;
+	meta_page = cpu_buffer->meta_page;
+	subbuf_ids = cpu_buffer->subbuf_ids;
+	cpu_buffer->meta_page = NULL;
+	cpu_buffer->subbuf_ids = NULL;
+	raw_spin_unlock_irqrestore(&cpu_buffer->reader_lock, flags);
+
+	kfree(subbuf_ids);
+	free_page((unsigned long)meta_page);
+
+ unlock:
+	mutex_unlock(&buffer->mutex);
+
+	return err;
+}
+
+/**
+ * ring_buffer_map_get_reader - consume the reader page and flip to the next
+ * @buffer: The ring buffer that is mapped
+ * @cpu: The per CPU buffer to advance
+ *
+ * Everything the meta page advertised on the reader page is considered
+ * consumed.  If the reader page is exhausted, a fresh page is swapped in
+ * from the ring and the meta page is updated to describe it.
+ */
+int ring_buffer_map_get_reader(struct trace_buffer *buffer, int cpu)
+{
+	struct ring_buffer_per_cpu *cpu_buffer;
+	unsigned long flags;
+	int err = 0;
+
+	if (!cpumask_test_cpu(cpu, buffer->cpumask))
+		return -EINVAL;
+
+	cpu_buffer = buffer->buffers[cpu];
+
+	raw_spin_lock_irqsave(&cpu_buffer->reader_lock, flags);
+
+	if (!cpu_buffer->mapped) {
+		err = -ENODEV;
+		goto unlock;
+	}
+
+	/* Consume what user space has already seen on the reader page */
+	while (cpu_buffer->reader_page->read <
+	       rb_page_commit(cpu_buffer->reader_page))
+		rb_advance_reader(cpu_buffer);
+
+	/* Swap in the next page if the current one is exhausted */
+	rb_get_reader_page(cpu_buffer);
+
+	rb_update_meta_page(cpu_buffer);
+
+	/* The lost events are now exposed in the meta page */
+	cpu_buffer->lost_events = 0;
+
+ unlock:
+	raw_spin_unlock_irqrestore(&cpu_buffer->reader_lock, flags);
+
+	return err;
+}
+
 /*
  * We only allocate new buffers, never free them if the CPU goes down.
  * If we were to free the buffer, then the user would lose any trace that was in
@@ -226,6 +226,7 @@ struct pool_workqueue {
 	int			nr_active;	/* L: nr of active works */
 	int			max_active;	/* L: max active works */
 	struct list_head	inactive_works;	/* L: inactive works */
+	unsigned long		inactive_since;	/* L: inactive_works went busy */
 	struct list_head	pwqs_node;	/* WR: node on wq->pwqs */
 	struct list_head	mayday_node;	/* MD: node on wq->maydays */
 
@@ -1178,6 +1179,47 @@ static void pwq_activate_first_inactive(struct pool_workqueue *pwq)
 	pwq_activate_inactive_work(work);
 }
 
+/*
+ * Queue latency above which a saturated pwq's max_active is considered
+ * undersized.  A boosted pwq may run up to twice the configured
+ * max_active (capped at WQ_MAX_ACTIVE) and falls back to the configured
+ * value once it drains, so a burst can only transiently raise the
+ * concurrency of the workqueue.
+ */
+#define PWQ_BOOST_THRESH	(HZ / 100)
+
+/*
+ * Called when @pwq is saturated (nr_active >= max_active) while work
+ * items wait on pwq->inactive_works.  If the backlog has been waiting
+ * longer than PWQ_BOOST_THRESH, widen max_active and release the first
+ * inactive work item.  Ordered workqueues must keep max_active at one
+ * and are never touched.
+ *
+ * CONTEXT:
+ * raw_spin_lock_irq(pool->lock).
+ */
+static void pwq_tune_max_active(struct pool_workqueue *pwq)
+{
+	struct workqueue_struct *wq = pwq->wq;
+
+	if (!(wq->flags & WQ_UNBOUND) || (wq->flags & __WQ_ORDERED))
+		return;
+
+	/* a frozen pwq (max_active == 0) must stay quiesced */
+	if (!pwq->max_active)
+		return;
+
+	if (time_before(jiffies, pwq->inactive_since + PWQ_BOOST_THRESH))
+		return;
+
+	if (pwq->max_active >= min(2 * wq->saved_max_active, WQ_MAX_ACTIVE))
+		return;
+
+	pwq->max_active++;
+	pwq->inactive_since = jiffies;
+	pwq_activate_first_inactive(pwq);
+}
+
 /**
  * pwq_dec_nr_in_flight - decrement pwq's nr_in_flight
  * @pwq: pwq of interest
@@ -1199,9 +1241,16 @@ static void pwq_dec_nr_in_flight(struct pool_workqueue *pwq, unsigned long work_
 			/* one down, submit an inactive one */
 			if (pwq->nr_active < pwq->max_active)
 				pwq_activate_first_inactive(pwq);
+			else
+				pwq_tune_max_active(pwq);
 		}
 	}
 
+	/* burst over; let a boosted pwq fall back to the configured limit */
+	if (!pwq->nr_active && list_empty(&pwq->inactive_works) &&
+	    pwq->max_active > pwq->wq->saved_max_active)
+		pwq->max_active = pwq->wq->saved_max_active;
+
 	pwq->nr_in_flight[color]--;
 
 	/* is flush in progress and are we at the flushing tip? */
@@ -1384,8 +1433,9 @@ static bool is_chained_work(struct workqueue_struct *wq)
 
 /*
  * When queueing an unbound work item to a wq, prefer local CPU if allowed
- * by wq_unbound_cpumask.  Otherwise, round robin among the allowed ones to
- * avoid perturbing sensitive tasks.
+ * by wq_unbound_cpumask.  Otherwise, round robin among the allowed ones,
+ * preferring the submitter's NUMA node, to avoid perturbing sensitive
+ * tasks without needlessly losing cache and memory locality.
  */
 static int wq_select_unbound_cpu(int cpu)
 {
@@ -1404,6 +1454,24 @@ static int wq_select_unbound_cpu(int cpu)
 		return cpu;
 
 	new_cpu = __this_cpu_read(wq_rr_cpu_last);
+
+	/* round robin among the allowed CPUs of the local node first */
+	if (!wq_debug_force_rr_cpu) {
+		const struct cpumask *node_mask =
+					cpumask_of_node(cpu_to_node(cpu));
+		int node_cpu;
+
+		node_cpu = cpumask_next_and(new_cpu, wq_unbound_cpumask,
+					    node_mask);
+		if (node_cpu >= nr_cpu_ids)
+			node_cpu = cpumask_first_and(wq_unbound_cpumask,
+						     node_mask);
+		if (node_cpu < nr_cpu_ids && cpu_online(node_cpu)) {
+			__this_cpu_write(wq_rr_cpu_last, node_cpu);
+			return node_cpu;
+		}
+	}
+
 	new_cpu = cpumask_next_and(new_cpu, wq_unbound_cpumask, cpu_online_mask);
 	if (unlikely(new_cpu >= nr_cpu_ids)) {
 		new_cpu = cpumask_first_and(wq_unbound_cpumask, cpu_online_mask);
@@ -1510,6 +1578,8 @@ retry:
 			pwq->pool->watchdog_ts = jiffies;
 	} else {
 		work_flags |= WORK_STRUCT_INACTIVE;
+		if (list_empty(&pwq->inactive_works))
+			pwq->inactive_since = jiffies;
 		worklist = &pwq->inactive_works;
 	}
 
@@ -10,6 +10,7 @@
 #include <asm-generic/mman-common.h>
 #include <linux/highmem.h>
 #include <linux/hugetlb.h>
+#include <linux/khugepaged.h>
 #include <linux/mmu_notifier.h>
 #include <linux/page_idle.h>
 #include <linux/pagewalk.h>
@@ -380,11 +381,10 @@ static const struct mm_walk_ops damon_mkold_ops = {
 	.hugetlb_entry = damon_mkold_hugetlb_entry,
 };
 
+/* Caller should hold mmap read lock of @mm */
 static void damon_va_mkold(struct mm_struct *mm, unsigned long addr)
 {
-	mmap_read_lock(mm);
 	walk_page_range(mm, addr, addr + 1, &damon_mkold_ops, NULL);
-	mmap_read_unlock(mm);
 }
 
 /*
@@ -409,8 +409,16 @@ static void damon_va_prepare_access_checks(struct damon_ctx *ctx)
 		mm = damon_get_mm(t);
 		if (!mm)
 			continue;
+		/*
+		 * Each sampling point needs only a single-address page table
+		 * walk, so take the mmap lock once per target instead of once
+		 * per region.  With many regions, the lock handover was
+		 * costing more than the walks themselves.
+		 */
+		mmap_read_lock(mm);
 		damon_for_each_region(r, t)
 			__damon_va_prepare_access_check(ctx, mm, r);
+		mmap_read_unlock(mm);
 		mmput(mm);
 	}
 }
@@ -512,6 +520,7 @@ static const struct mm_walk_ops damon_young_ops = {
 	.hugetlb_entry = damon_young_hugetlb_entry,
 };
 
+/* Caller should hold mmap read lock of @mm */
 static bool damon_va_young(struct mm_struct *mm, unsigned long addr,
 		unsigned long *page_sz)
 {
@@ -520,9 +529,7 @@ static bool damon_va_young(struct mm_struct *mm, unsigned long addr,
 		.young = false,
 	};
 
-	mmap_read_lock(mm);
 	walk_page_range(mm, addr, addr + 1, &damon_young_ops, &arg);
-	mmap_read_unlock(mm);
 	return arg.young;
 }
 
@@ -567,10 +574,13 @@ static unsigned int damon_va_check_accesses(struct damon_ctx *ctx)
 		mm = damon_get_mm(t);
 		if (!mm)
 			continue;
+		/* As in damon_va_prepare_access_checks(), lock per target */
+		mmap_read_lock(mm);
 		damon_for_each_region(r, t) {
 			__damon_va_check_access(ctx, mm, r);
 			max_nr_accesses = max(r->nr_accesses, max_nr_accesses);
 		}
+		mmap_read_unlock(mm);
 		mmput(mm);
 	}
 
@@ -626,6 +636,7 @@ static unsigned long damon_va_apply_scheme(struct damon_ctx *ctx,
 		struct damos *scheme)
 {
 	int madv_action;
+	unsigned long applied;
 
 	switch (scheme->action) {
 	case DAMOS_WILLNEED:
@@ -649,7 +660,16 @@ static unsigned long damon_va_apply_scheme(struct damon_ctx *ctx,
 		return 0;
 	}
 
-	return damos_madvise(t, r, madv_action);
+	applied = damos_madvise(t, r, madv_action);
+	/*
+	 * MADV_HUGEPAGE only marks the region as eligible; collapsing is up
+	 * to khugepaged.  Kick it so a hot region found by the scheme gets
+	 * huge pages now, not after khugepaged's next scheduled scan.
+	 */
+	if (applied && scheme->action == DAMOS_HUGEPAGE)
+		khugepaged_kick();
+
+	return applied;
 }
 
 static int damon_va_scheme_score(struct damon_ctx *context,
@@ -868,6 +868,31 @@ noinline int __filemap_add_folio(struct address_space *mapping,
 	folio->mapping = mapping;
 	folio->index = xas.xa_index;
 
+	/*
+	 * If the tree needs to grow for this index, the node is otherwise
+	 * allocated GFP_NOWAIT under xa_lock or via an extra
+	 * unlock/xas_nomem()/relock round trip, both of which inflate
+	 * xa_lock hold times when many threads populate one mapping.
+	 * Probe under RCU and allocate one node up front while we may
+	 * still sleep; an unused node is returned by xas_destroy() when
+	 * xas_nomem() terminates the loop below.
+	 */
+	if (gfpflags_allow_blocking(gfp)) {
+		bool needs_node;
+
+		rcu_read_lock();
+		xas_load(&xas);
+		needs_node = xas_invalid(&xas) || !xas.xa_node ||
+			     xas.xa_node->shift > xas.xa_shift;
+		rcu_read_unlock();
+		xas_reset(&xas);
+
+		if (needs_node) {
+			xas_set_err(&xas, -ENOMEM);
+			xas_nomem(&xas, gfp);
+		}
+	}
+
 	do {
 		unsigned int order = xa_get_order(xas.xa, xas.xa_index);
 		void *entry, *old = NULL;
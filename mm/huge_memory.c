@@ -771,6 +771,12 @@ vm_fault_t do_huge_pmd_anonymous_page(struct vm_fault *vmf)
 	folio = vma_alloc_folio(gfp, HPAGE_PMD_ORDER, vma, haddr, true);
 	if (unlikely(!folio)) {
 		count_vm_event(THP_FAULT_FALLBACK);
+		/*
+		 * The range is hot right now but will be mapped with base
+		 * pages; have khugepaged pick it up promptly rather than
+		 * minutes from now.
+		 */
+		khugepaged_kick();
 		return VM_FAULT_FALLBACK;
 	}
 	return __do_huge_pmd_anonymous_page(vmf, &folio->page, gfp);
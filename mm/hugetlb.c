@@ -5734,6 +5734,34 @@ vm_fault_t hugetlb_fault(struct mm_struct *mm, struct vm_area_struct *vma,
 		return VM_FAULT_OOM;
 	}
 
+	/*
+	 * Fast path for ptes that are already present and sufficient for
+	 * the access: all that is left to do is set the young (and for
+	 * writes, dirty) bits.  This needs neither the fault mutex (no
+	 * allocation can race) nor the page lock, and matters when many
+	 * threads storm the same pages, e.g. while a large database warms
+	 * up.  The pte is revalidated under its lock; any race just falls
+	 * back to the slow path below.
+	 */
+	entry = huge_ptep_get(ptep);
+	if (pte_present(entry) &&
+	    (!(flags & (FAULT_FLAG_WRITE|FAULT_FLAG_UNSHARE)) ||
+	     huge_pte_write(entry))) {
+		ptl = huge_pte_lock(h, mm, ptep);
+		if (likely(pte_same(entry, huge_ptep_get(ptep)))) {
+			if (flags & FAULT_FLAG_WRITE)
+				entry = huge_pte_mkdirty(entry);
+			entry = pte_mkyoung(entry);
+			if (huge_ptep_set_access_flags(vma, haddr, ptep, entry,
+						flags & FAULT_FLAG_WRITE))
+				update_mmu_cache(vma, haddr, ptep);
+			spin_unlock(ptl);
+			i_mmap_unlock_read(mapping);
+			return 0;
+		}
+		spin_unlock(ptl);
+	}
+
 	/*
 	 * Serialize hugepage allocation and instantiation, so that we don't
 	 * get spurious allocation failures if two CPUs race to instantiate
@@ -146,6 +146,17 @@ static ssize_t scan_sleep_millisecs_store(struct kobject *kobj,
 
 	return count;
 }
+/*
+ * Called when a THP fault had to fall back to base pages: the region is
+ * being touched right now, so cut the current scan sleep short instead
+ * of letting the collapse wait out the full scan_sleep_millisecs.
+ */
+void khugepaged_kick(void)
+{
+	khugepaged_sleep_expire = 0;
+	wake_up_interruptible(&khugepaged_wait);
+}
+
 static struct kobj_attribute scan_sleep_millisecs_attr =
 	__ATTR(scan_sleep_millisecs, 0644, scan_sleep_millisecs_show,
 	       scan_sleep_millisecs_store);
@@ -1110,6 +1121,12 @@ static void collapse_huge_page(struct mm_struct *mm,
 	if (mm_find_pmd(mm, address) != pmd)
 		goto out_up_write;
 
+	/*
+	 * The PTE page table is about to be collapsed under us; wait out
+	 * faults being handled under the per-VMA lock.
+	 */
+	vma_start_write(vma);
+
 	anon_vma_lock_write(vma->anon_vma);
 
 	mmu_notifier_range_init(&range, MMU_NOTIFY_CLEAR, 0, NULL, mm,
@@ -1720,8 +1737,8 @@ static void collapse_file(struct mm_struct *mm,
 			if (xa_is_value(page) || !PageUptodate(page)) {
 				xas_unlock_irq(&xas);
 				/* swap in or instantiate fallocated page */
-				if (shmem_getpage(mapping->host, index, &page,
-						  SGP_NOALLOC)) {
+				if (shmem_getpage(mapping->host, index, 0,
+						  &page, SGP_NOALLOC)) {
 					result = SCAN_FAIL;
 					goto xa_unlocked;
 				}
@@ -2110,6 +2110,15 @@ void unlock_page_memcg(struct page *page)
 	folio_memcg_unlock(page_folio(page));
 }
 
+/*
+ * Extra pages charged into the per-CPU object stock on a miss, and with
+ * that the amount of pre-charged bytes the stock may retain.  Larger
+ * values trade accounting accuracy (up to this many pages per CPU can
+ * be charged but unused) for fewer page_counter round trips on the
+ * kmalloc fast path.
+ */
+#define OBJ_STOCK_EXTRA_PAGES	4
+
 struct memcg_stock_pcp {
 	local_lock_t stock_lock;
 	struct mem_cgroup *cached; /* this never be root cgroup */
@@ -3236,9 +3245,16 @@ static void refill_obj_stock(struct obj_cgroup *objcg, unsigned int nr_bytes,
 	}
 	stock->nr_bytes += nr_bytes;
 
-	if (allow_uncharge && (stock->nr_bytes > PAGE_SIZE)) {
-		nr_pages = stock->nr_bytes >> PAGE_SHIFT;
-		stock->nr_bytes &= (PAGE_SIZE - 1);
+	/*
+	 * Let the stock retain up to OBJ_STOCK_EXTRA_PAGES of pre-charged
+	 * bytes, so that a charge top-up is not returned to the counters
+	 * right away by the next free of the same size.
+	 */
+	if (allow_uncharge &&
+	    (stock->nr_bytes > (OBJ_STOCK_EXTRA_PAGES + 1) * PAGE_SIZE)) {
+		nr_pages = (stock->nr_bytes >> PAGE_SHIFT) -
+			   OBJ_STOCK_EXTRA_PAGES;
+		stock->nr_bytes -= nr_pages << PAGE_SHIFT;
 	}
 
 	local_unlock_irqrestore(&memcg_stock.stock_lock, flags);
@@ -3275,10 +3291,10 @@ int obj_cgroup_charge(struct obj_cgroup *objcg, gfp_t gfp, size_t size)
 	 * pre-charged bytes as well when charging pages. To avoid a
 	 * page uncharge right after a page charge, we set the
 	 * allow_uncharge flag to false when calling refill_obj_stock()
-	 * to temporarily allow the pre-charged bytes to exceed the page
-	 * size limit. The maximum reachable value of the pre-charged
-	 * bytes is (sizeof(object) + PAGE_SIZE - 2) if there is no data
-	 * race.
+	 * to temporarily allow the pre-charged bytes to exceed the
+	 * retained limit. The maximum reachable value of the pre-charged
+	 * bytes is (sizeof(object) + (OBJ_STOCK_EXTRA_PAGES + 1) *
+	 * PAGE_SIZE - 2) if there is no data race.
 	 */
 	nr_pages = size >> PAGE_SHIFT;
 	nr_bytes = size & (PAGE_SIZE - 1);
@@ -3286,6 +3302,21 @@ int obj_cgroup_charge(struct obj_cgroup *objcg, gfp_t gfp, size_t size)
 	if (nr_bytes)
 		nr_pages += 1;
 
+	/*
+	 * A stock miss means a page_counter round trip, a css reference
+	 * pair and a vmstat flush, so try to charge a few extra pages in
+	 * one go and park them in the stock as pre-charged bytes.  The
+	 * top-up must not apply pressure on behalf of bytes nobody asked
+	 * for yet, so it is attempted without direct reclaim and we fall
+	 * back to an exact charge when the limit is close.
+	 */
+	if (!obj_cgroup_charge_pages(objcg, gfp & ~__GFP_DIRECT_RECLAIM,
+				     nr_pages + OBJ_STOCK_EXTRA_PAGES)) {
+		refill_obj_stock(objcg, (OBJ_STOCK_EXTRA_PAGES << PAGE_SHIFT) +
+				 (nr_bytes ? PAGE_SIZE - nr_bytes : 0), false);
+		return 0;
+	}
+
 	ret = obj_cgroup_charge_pages(objcg, gfp, nr_pages);
 	if (!ret && nr_bytes)
 		refill_obj_stock(objcg, PAGE_SIZE - nr_bytes, false);
@@ -6419,19 +6450,49 @@ static ssize_t memory_reclaim(struct kernfs_open_file *of, char *buf,
 	struct mem_cgroup *memcg = mem_cgroup_from_css(of_css(of));
 	unsigned int nr_retries = MAX_RECLAIM_RETRIES;
 	unsigned long nr_to_reclaim, nr_reclaimed = 0;
+	unsigned long rate_pages = 0;
+	char *space;
 	int err;
 
 	buf = strstrip(buf);
+
+	/*
+	 * "<size> [rate=<bytes per second>]".  A rate paces the reclaim in
+	 * ~100ms slices so a tenant can be shrunk gradually instead of in
+	 * one refault-storm-inducing burst.  "rate=max" means unpaced.
+	 */
+	space = strchr(buf, ' ');
+	if (space) {
+		char *arg = skip_spaces(space + 1);
+
+		*space = '\0';
+		if (strncmp(arg, "rate=", 5))
+			return -EINVAL;
+		err = page_counter_memparse(arg + 5, "max", &rate_pages);
+		if (err)
+			return err;
+		if (!rate_pages)
+			return -EINVAL;
+		if (rate_pages == PAGE_COUNTER_MAX)
+			rate_pages = 0;
+	}
+
 	err = page_counter_memparse(buf, "", &nr_to_reclaim);
 	if (err)
 		return err;
 
 	while (nr_reclaimed < nr_to_reclaim) {
+		unsigned long batch = nr_to_reclaim - nr_reclaimed;
 		unsigned long reclaimed;
 
 		if (signal_pending(current))
 			return -EINTR;
 
+		if (rate_pages)
+			batch = min(batch,
+				    max_t(unsigned long, rate_pages / 10,
+					  SWAP_CLUSTER_MAX));
+
 		/*
 		 * This is the final attempt, drain percpu lru caches in the
 		 * hope of introducing more evictable pages for
@@ -6440,14 +6501,17 @@ static ssize_t memory_reclaim(struct kernfs_open_file *of, char *buf,
 		if (!nr_retries)
 			lru_add_drain_all();
 
-		reclaimed = try_to_free_mem_cgroup_pages(memcg,
-						nr_to_reclaim - nr_reclaimed,
+		reclaimed = try_to_free_mem_cgroup_pages(memcg, batch,
 						GFP_KERNEL, true);
 
 		if (!reclaimed && !nr_retries--)
 			return -EAGAIN;
 
 		nr_reclaimed += reclaimed;
+
+		if (rate_pages && nr_reclaimed < nr_to_reclaim &&
+		    schedule_timeout_interruptible(HZ / 10))
+			return -EINTR;
 	}
 
 	return nbytes;
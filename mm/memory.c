@@ -1750,6 +1750,33 @@ void zap_page_range(struct vm_area_struct *vma, unsigned long start,
 	tlb_finish_mmu(&tlb);
 }
 
+/**
+ * zap_page_range_batched - remove user pages in a given range using a
+ * caller-provided mmu_gather
+ * @tlb: the mmu_gather to accumulate into
+ * @vma: vm_area_struct holding the applicable pages
+ * @start: starting address of pages to zap
+ * @size: number of bytes to zap
+ *
+ * Like zap_page_range(), but defers the TLB flush and page freeing to
+ * the caller's tlb_finish_mmu(), so several independent ranges can
+ * share a single shootdown.  Caller must have used tlb_gather_mmu().
+ */
+void zap_page_range_batched(struct mmu_gather *tlb, struct vm_area_struct *vma,
+		unsigned long start, unsigned long size)
+{
+	struct mmu_notifier_range range;
+
+	lru_add_drain();
+	mmu_notifier_range_init(&range, MMU_NOTIFY_CLEAR, 0, vma, vma->vm_mm,
+				start, start + size);
+	update_hiwater_rss(vma->vm_mm);
+	mmu_notifier_invalidate_range_start(&range);
+	for ( ; vma && vma->vm_start < range.end; vma = vma->vm_next)
+		unmap_single_vma(tlb, vma, start, range.end, NULL);
+	mmu_notifier_invalidate_range_end(&range);
+}
+
 /**
  * zap_page_range_single - remove user pages in a given range
  * @vma: vm_area_struct holding the applicable pages
@@ -3723,6 +3750,15 @@ vm_fault_t do_swap_page(struct vm_fault *vmf)
 	if (!pte_unmap_same(vmf))
 		goto out;
 
+	if (vmf->flags & FAULT_FLAG_VMA_LOCK) {
+		/*
+		 * Swap-in can block on I/O and may have to drop mmap_lock
+		 * (folio lock, readahead); punt to the mmap_lock path.
+		 */
+		ret = VM_FAULT_RETRY;
+		goto out;
+	}
+
 	entry = pte_to_swp_entry(vmf->orig_pte);
 	if (unlikely(non_swap_entry(entry))) {
 		if (is_migration_entry(entry)) {
@@ -4458,6 +4494,20 @@ static vm_fault_t do_fault_around(struct vm_fault *vmf)
 	int off;
 
 	nr_pages = READ_ONCE(fault_around_bytes) >> PAGE_SHIFT;
+
+	/*
+	 * If this fault has to populate a fresh page table for a shared
+	 * mapping, widen the window to the whole table.  This is the
+	 * pattern of a process mapping an already warm file or shmem
+	 * segment (e.g. workers forked off a primary that populated a big
+	 * shared buffer): the pages are resident, and taking a fault per
+	 * fault_around_bytes just to refill page tables the parent already
+	 * had is pure overhead.  ->map_pages() skips pages that are not
+	 * ready, so a cold range costs no more than a page cache scan.
+	 */
+	if ((vmf->vma->vm_flags & VM_SHARED) && pmd_none(*vmf->pmd))
+		nr_pages = PTRS_PER_PTE;
+
 	mask = ~(nr_pages * PAGE_SIZE - 1) & PAGE_MASK;
 
 	address = max(address & mask, vmf->vma->vm_start);
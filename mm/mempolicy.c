@@ -773,6 +773,11 @@ static int vma_replace_policy(struct vm_area_struct *vma,
 			goto err_out;
 	}
 
+	/*
+	 * Lock-free faults reach the old policy through get_vma_policy()
+	 * without taking a reference; drain them before freeing it.
+	 */
+	vma_start_write(vma);
 	old = vma->vm_policy;
 	vma->vm_policy = new; /* protected by mmap_lock */
 	mpol_put(old);
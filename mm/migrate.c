@@ -1708,6 +1708,7 @@ static int do_pages_move(struct mm_struct *mm, nodemask_t task_nodes,
 	for (i = start = 0; i < nr_pages; i++) {
 		const void __user *p;
 		unsigned long addr;
+		int lookup_err;
 		int node;
 
 		err = -EFAULT;
@@ -1759,13 +1760,28 @@ static int do_pages_move(struct mm_struct *mm, nodemask_t task_nodes,
 			err = -EFAULT;
 
 		/*
-		 * If the page is already on the target node (!err), store the
-		 * node, otherwise, store the err.
+		 * If the page is already on the target node (!lookup_err),
+		 * store the node, otherwise, store the err.
 		 */
-		err = store_status(status, i, err ? : current_node, 1);
+		lookup_err = err;
+		err = store_status(status, i, lookup_err ? : current_node, 1);
 		if (err)
 			goto out_flush;
 
+		/*
+		 * A page that was already on the target node only had its
+		 * status stored individually - with the same value the
+		 * batched store below would write.  Keep accumulating the
+		 * batch in that case: flushing here would collapse large
+		 * move_pages() vectors into single-page migrate_pages()
+		 * calls whenever the vector contains already-placed pages.
+		 * A lookup/isolation error stores a value the ranged store
+		 * must not overwrite, so those still flush and restart the
+		 * batch window.
+		 */
+		if (!lookup_err)
+			continue;
+
 		err = move_pages_and_store_status(mm, current_node, &pagelist,
 				status, start, i, nr_pages);
 		if (err)
@@ -438,6 +438,7 @@ static int mlock_fixup(struct vm_area_struct *vma, struct vm_area_struct **prev,
 	}
 
 success:
+	vma_start_write(vma);
 	/*
 	 * Keep track of amount of locked VM.
 	 */
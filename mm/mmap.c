@@ -47,6 +47,7 @@
 #include <linux/moduleparam.h>
 #include <linux/pkeys.h>
 #include <linux/oom.h>
+#include <linux/prefetch.h>
 #include <linux/sched/mm.h>
 
 #include <linux/uaccess.h>
@@ -757,6 +758,11 @@ int __vma_adjust(struct vm_area_struct *vma, unsigned long start,
 	long adjust_next = 0;
 	int remove_next = 0;
 
+	/* Wait out lock-free faults on the VMAs we are about to touch. */
+	vma_start_write(vma);
+	if (next)
+		vma_start_write(next);
+
 	if (next && !insert) {
 		struct vm_area_struct *exporter = NULL, *importer = NULL;
 
@@ -2311,6 +2317,14 @@ struct vm_area_struct *find_vma(struct mm_struct *mm, unsigned long addr)
 	while (rb_node) {
 		struct vm_area_struct *tmp;
 
+		/*
+		 * The descent is a pointer chase through cold nodes; start
+		 * pulling in both children while we examine this one so the
+		 * next iteration does not stall on a full cache miss.
+		 */
+		prefetch(rb_node->rb_left);
+		prefetch(rb_node->rb_right);
+
 		tmp = rb_entry(rb_node, struct vm_area_struct, vm_rb);
 
 		if (tmp->vm_end > addr) {
@@ -2431,6 +2445,10 @@ int expand_upwards(struct vm_area_struct *vma, unsigned long address)
 	 * vma->vm_start/vm_end cannot change under us because the caller
 	 * is required to hold the mmap_lock in read mode.  We need the
 	 * anon_vma lock to serialize against concurrent expand_stacks.
+	 *
+	 * Unlike expand_downwards(), no VMA lock is needed: growing
+	 * vm_end leaves the address->pgoff mapping of the existing range
+	 * intact, so a lock-free fault inside it is unaffected.
 	 */
 	anon_vma_lock_write(vma->anon_vma);
 
@@ -2511,7 +2529,14 @@ int expand_downwards(struct vm_area_struct *vma,
 	 * vma->vm_start/vm_end cannot change under us because the caller
 	 * is required to hold the mmap_lock in read mode.  We need the
 	 * anon_vma lock to serialize against concurrent expand_stacks.
+	 *
+	 * Moving vm_start/vm_pgoff changes the address->pgoff mapping
+	 * that a lock-free fault on this VMA may be using right now, and
+	 * mmap_lock held for reading does not stop new such faults from
+	 * starting, so draining is not enough: hold the VMA lock across
+	 * the update.
 	 */
+	vma_write_lock(vma);
 	anon_vma_lock_write(vma->anon_vma);
 
 	/* Somebody else might have raced and expanded it already */
@@ -2552,6 +2577,7 @@ int expand_downwards(struct vm_area_struct *vma,
 		}
 	}
 	anon_vma_unlock_write(vma->anon_vma);
+	vma_write_unlock(vma);
 	khugepaged_enter_vma(vma, vma->vm_flags);
 	validate_mm(mm);
 	return error;
@@ -2685,6 +2711,7 @@ detach_vmas_to_be_unmapped(struct mm_struct *mm, struct vm_area_struct *vma,
 	insertion_point = (prev ? &prev->vm_next : &mm->mmap);
 	vma->vm_prev = NULL;
 	do {
+		vma_start_write(vma);
 		vma_rb_erase(vma, &mm->mm_rb);
 		if (vma->vm_flags & VM_LOCKED)
 			mm->locked_vm -= vma_pages(vma);
@@ -594,6 +594,12 @@ static unsigned long move_vma(struct vm_area_struct *vma,
 	if (unlikely(flags & MREMAP_DONTUNMAP))
 		to_account = new_len;
 
+	/*
+	 * move_page_tables() empties the old range's page tables, which
+	 * must not race with lock-free faults filling them back in.
+	 */
+	vma_start_write(vma);
+
 	if (vma->vm_ops && vma->vm_ops->may_split) {
 		if (vma->vm_start != old_addr)
 			err = vma->vm_ops->may_split(vma, old_addr);
@@ -3515,6 +3515,86 @@ void free_unref_page_list(struct list_head *list)
 	local_unlock_irqrestore(&pagesets.lock, flags);
 }
 
+/*
+ * Free a batch of order-0 pages from an array - the counterpart of
+ * alloc_pages_bulk_array().  A reference is dropped on each page; pages
+ * whose refcount reaches zero are returned to the per-CPU lists under a
+ * single local lock section instead of one lock/IRQ cycle per page.
+ * Freed slots are set to NULL so the array can be refilled.
+ */
+void free_pages_bulk_array(unsigned long nr_pages, struct page **page_array)
+{
+	unsigned long flags;
+	unsigned long i;
+	int batch_count = 0;
+	int migratetype;
+
+	/* Prepare pages for freeing */
+	for (i = 0; i < nr_pages; i++) {
+		struct page *page = page_array[i];
+		unsigned long pfn;
+
+		if (!page)
+			continue;
+
+		VM_BUG_ON_PAGE(PageCompound(page), page);
+		if (!put_page_testzero(page)) {
+			page_array[i] = NULL;
+			continue;
+		}
+
+		pfn = page_to_pfn(page);
+		if (!free_unref_page_prepare(page, pfn, 0)) {
+			page_array[i] = NULL;
+			continue;
+		}
+
+		/*
+		 * Free isolated pages directly to the allocator, see
+		 * comment in free_unref_page.
+		 */
+		migratetype = get_pcppage_migratetype(page);
+		if (unlikely(is_migrate_isolate(migratetype))) {
+			free_one_page(page_zone(page), page, pfn, 0,
+				      migratetype, FPI_NONE);
+			page_array[i] = NULL;
+			continue;
+		}
+	}
+
+	local_lock_irqsave(&pagesets.lock, flags);
+	for (i = 0; i < nr_pages; i++) {
+		struct page *page = page_array[i];
+
+		if (!page)
+			continue;
+
+		/*
+		 * Non-isolated types over MIGRATE_PCPTYPES get added
+		 * to the MIGRATE_MOVABLE pcp list.
+		 */
+		migratetype = get_pcppage_migratetype(page);
+		if (unlikely(migratetype >= MIGRATE_PCPTYPES))
+			migratetype = MIGRATE_MOVABLE;
+
+		trace_mm_page_free_batched(page);
+		free_unref_page_commit(page, migratetype, 0);
+		page_array[i] = NULL;
+
+		/*
+		 * Guard against excessive IRQ disabled times when we get
+		 * a large list of pages to free.
+		 */
+		if (++batch_count == SWAP_CLUSTER_MAX) {
+			local_unlock_irqrestore(&pagesets.lock, flags);
+			batch_count = 0;
+			local_lock_irqsave(&pagesets.lock, flags);
+		}
+	}
+	local_unlock_irqrestore(&pagesets.lock, flags);
+}
+EXPORT_SYMBOL_GPL(free_pages_bulk_array);
+
 /*
  * split_page takes a non-compound higher-order page, and splits it into
  * n (1<<order) sub-pages: page[0..n]
@@ -5021,8 +5101,18 @@ retry_cpuset:
 			 *    own.
 			 */
 			if (compact_result == COMPACT_SKIPPED ||
-			    compact_result == COMPACT_DEFERRED)
+			    compact_result == COMPACT_DEFERRED) {
+				/*
+				 * Hand the work to kcompactd before bailing
+				 * out, so that memory is compacted in the
+				 * background and a later attempt (e.g. the
+				 * next THP fault in this range) can succeed
+				 * without eating the latency synchronously.
+				 */
+				if (alloc_flags & ALLOC_KSWAPD)
+					wake_all_kswapds(order, gfp_mask, ac);
 				goto nopage;
+			}
 
 			/*
 			 * Looks like reclaim/compaction is worth trying, but
@@ -630,6 +630,26 @@ static void ondemand_readahead(struct readahead_control *ractl,
 	if (index - prev_index <= 1UL)
 		goto initial_readahead;
 
+	/*
+	 * Constant-stride forward scan.  Strided reads miss the sequential
+	 * check above and would reset the window to the initial size on
+	 * every read; as long as the step between misses is stable and
+	 * smaller than the maximum window, treat the stream as sequential
+	 * and keep ramping the window up so the device stays busy.
+	 */
+	if (index > prev_index) {
+		unsigned long stride = index - prev_index;
+
+		if (stride == ra->stride && stride <= max_pages) {
+			ra->start = index;
+			ra->size = get_next_ra_size(ra, max_pages);
+			ra->async_size = ra->size > req_size ?
+					ra->size - req_size : ra->size;
+			goto readit;
+		}
+		ra->stride = stride;
+	}
+
 	/*
 	 * Query the page cache and look for the traces(cached history pages)
 	 * that a sequential stream would leave behind.
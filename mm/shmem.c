@@ -139,14 +139,14 @@ static int shmem_swapin_folio(struct inode *inode, pgoff_t index,
 			     gfp_t gfp, struct vm_area_struct *vma,
 			     vm_fault_t *fault_type);
 static int shmem_getpage_gfp(struct inode *inode, pgoff_t index,
-		struct page **pagep, enum sgp_type sgp,
+		loff_t write_end, struct page **pagep, enum sgp_type sgp,
 		gfp_t gfp, struct vm_area_struct *vma,
 		struct vm_fault *vmf, vm_fault_t *fault_type);
 
-int shmem_getpage(struct inode *inode, pgoff_t index,
+int shmem_getpage(struct inode *inode, pgoff_t index, loff_t write_end,
 		struct page **pagep, enum sgp_type sgp)
 {
-	return shmem_getpage_gfp(inode, index, pagep, sgp,
+	return shmem_getpage_gfp(inode, index, write_end, pagep, sgp,
 		mapping_gfp_mask(inode->i_mapping), NULL, NULL, NULL);
 }
 
@@ -472,7 +472,7 @@ static bool shmem_confirm_swap(struct address_space *mapping,
 static int shmem_huge __read_mostly = SHMEM_HUGE_NEVER;
 
 bool shmem_is_huge(struct vm_area_struct *vma,
-		   struct inode *inode, pgoff_t index)
+		   struct inode *inode, pgoff_t index, loff_t write_end)
 {
 	loff_t i_size;
 
@@ -491,7 +491,8 @@ bool shmem_is_huge(struct vm_area_struct *vma,
 		return true;
 	case SHMEM_HUGE_WITHIN_SIZE:
 		index = round_up(index + 1, HPAGE_PMD_NR);
-		i_size = round_up(i_size_read(inode), PAGE_SIZE);
+		i_size = max(write_end, i_size_read(inode));
+		i_size = round_up(i_size, PAGE_SIZE);
 		if (i_size >> PAGE_SHIFT >= index)
 			return true;
 		fallthrough;
@@ -680,7 +681,7 @@ static long shmem_unused_huge_count(struct super_block *sb,
 #define shmem_huge SHMEM_HUGE_DENY
 
 bool shmem_is_huge(struct vm_area_struct *vma,
-		   struct inode *inode, pgoff_t index)
+		   struct inode *inode, pgoff_t index, loff_t write_end)
 {
 	return false;
 }
@@ -901,7 +902,7 @@ static struct folio *shmem_get_partial_folio(struct inode *inode, pgoff_t index)
 	 * (although in some cases this is just a waste of time).
 	 */
 	page = NULL;
-	shmem_getpage(inode, index, &page, SGP_READ);
+	shmem_getpage(inode, index, 0, &page, SGP_READ);
 	return page ? page_folio(page) : NULL;
 }
 
@@ -1060,7 +1061,7 @@ static int shmem_getattr(struct user_namespace *mnt_userns,
 	}
 	generic_fillattr(&init_user_ns, inode, stat);
 
-	if (shmem_is_huge(NULL, inode, 0))
+	if (shmem_is_huge(NULL, inode, 0, 0))
 		stat->blksize = HPAGE_PMD_SIZE;
 
 	if (request_mask & STATX_BTIME) {
@@ -1820,7 +1821,7 @@ unlock:
  * otherwise they are NULL.
  */
 static int shmem_getpage_gfp(struct inode *inode, pgoff_t index,
-	struct page **pagep, enum sgp_type sgp, gfp_t gfp,
+	loff_t write_end, struct page **pagep, enum sgp_type sgp, gfp_t gfp,
 	struct vm_area_struct *vma, struct vm_fault *vmf,
 			vm_fault_t *fault_type)
 {
@@ -1898,7 +1899,7 @@ repeat:
 		return 0;
 	}
 
-	if (!shmem_is_huge(vma, inode, index))
+	if (!shmem_is_huge(vma, inode, index, write_end))
 		goto alloc_nohuge;
 
 	huge_gfp = vma_thp_gfp_mask(vma);
@@ -2113,7 +2114,7 @@ static vm_fault_t shmem_fault(struct vm_fault *vmf)
 		spin_unlock(&inode->i_lock);
 	}
 
-	err = shmem_getpage_gfp(inode, vmf->pgoff, &vmf->page, SGP_CACHE,
+	err = shmem_getpage_gfp(inode, vmf->pgoff, 0, &vmf->page, SGP_CACHE,
 				  gfp, vma, vmf, &ret);
 	if (err)
 		return vmf_error(err);
@@ -2470,7 +2471,7 @@ shmem_write_begin(struct file *file, struct address_space *mapping,
 			return -EPERM;
 	}
 
-	ret = shmem_getpage(inode, index, pagep, SGP_WRITE);
+	ret = shmem_getpage(inode, index, pos + len, pagep, SGP_WRITE);
 
 	if (ret)
 		return ret;
@@ -2550,7 +2551,7 @@ static ssize_t shmem_file_read_iter(struct kiocb *iocb, struct iov_iter *to)
 				break;
 		}
 
-		error = shmem_getpage(inode, index, &page, SGP_READ);
+		error = shmem_getpage(inode, index, 0, &page, SGP_READ);
 		if (error) {
 			if (error == -EINVAL)
 				error = 0;
@@ -2755,7 +2756,9 @@ static long shmem_fallocate(struct file *file, int mode, loff_t offset,
 		else if (shmem_falloc.nr_unswapped > shmem_falloc.nr_falloced)
 			error = -ENOMEM;
 		else
-			error = shmem_getpage(inode, index, &page, SGP_FALLOC);
+			error = shmem_getpage(inode, index,
+					      (loff_t)end << PAGE_SHIFT,
+					      &page, SGP_FALLOC);
 		if (error) {
 			info->fallocend = undo_fallocend;
 			/* Remove the !PageUptodate pages we added */
@@ -3079,7 +3082,7 @@ static int shmem_symlink(struct user_namespace *mnt_userns, struct inode *dir,
 		inode->i_op = &shmem_short_symlink_operations;
 	} else {
 		inode_nohighmem(inode);
-		error = shmem_getpage(inode, 0, &page, SGP_WRITE);
+		error = shmem_getpage(inode, 0, 0, &page, SGP_WRITE);
 		if (error) {
 			iput(inode);
 			return error;
@@ -3121,7 +3124,7 @@ static const char *shmem_get_link(struct dentry *dentry,
 			return ERR_PTR(-ECHILD);
 		}
 	} else {
-		error = shmem_getpage(inode, 0, &page, SGP_READ);
+		error = shmem_getpage(inode, 0, 0, &page, SGP_READ);
 		if (error)
 			return ERR_PTR(error);
 		if (!page)
@@ -4197,7 +4200,7 @@ struct page *shmem_read_mapping_page_gfp(struct address_space *mapping,
 	int error;
 
 	BUG_ON(!shmem_mapping(mapping));
-	error = shmem_getpage_gfp(inode, index, &page, SGP_CACHE,
+	error = shmem_getpage_gfp(inode, index, 0, &page, SGP_CACHE,
 				  gfp, NULL, NULL, NULL);
 	if (error)
 		return ERR_PTR(error);
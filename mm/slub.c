@@ -2175,7 +2175,19 @@ static void *get_partial_node(struct kmem_cache *s, struct kmem_cache_node *n,
 	if (!n || !n->nr_partial)
 		return NULL;
 
-	spin_lock_irqsave(&n->list_lock, flags);
+	if (!spin_trylock_irqsave(&n->list_lock, flags)) {
+		/*
+		 * The node's list_lock is the serialization point when many
+		 * CPUs miss their cpu_slab at once.  Callers that may
+		 * reclaim are better served by falling back to another node
+		 * or the page allocator than by joining the lock queue;
+		 * only sleepless allocations, which cannot fall back to
+		 * reclaim, insist on the partial list.
+		 */
+		if (gfpflags & __GFP_DIRECT_RECLAIM)
+			return NULL;
+		spin_lock_irqsave(&n->list_lock, flags);
+	}
 	list_for_each_entry_safe(slab, slab2, &n->partial, slab_list) {
 		void *t;
 
@@ -1059,7 +1059,7 @@ int get_swap_pages(int n_goal, swp_entry_t swp_entries[], int entry_size)
 		goto noswap;
 	}
 
-	n_goal = min3((long)n_goal, (long)SWAP_BATCH, avail_pgs);
+	n_goal = min3((long)n_goal, (long)SWAP_SLOTS_CACHE_SIZE, avail_pgs);
 
 	atomic_long_sub(n_goal * size, &nr_swap_pages);
 
@@ -246,7 +246,7 @@ static int mcontinue_atomic_pte(struct mm_struct *dst_mm,
 	struct page *page;
 	int ret;
 
-	ret = shmem_getpage(inode, pgoff, &page, SGP_NOALLOC);
+	ret = shmem_getpage(inode, pgoff, 0, &page, SGP_NOALLOC);
 	/* Our caller expects us to return -EFAULT if we failed to find page. */
 	if (ret == -ENOENT)
 		ret = -EFAULT;
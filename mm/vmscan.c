@@ -1410,6 +1410,16 @@ static enum page_references folio_check_references(struct folio *folio,
 		if (referenced_folio || referenced_ptes > 1)
 			return PAGEREF_ACTIVATE;
 
+		/*
+		 * A refaulting folio that is referenced again has proven
+		 * itself hot across two stints on the LRU; activate it
+		 * right away instead of making it earn another reference
+		 * on the inactive list, or reclaim will keep evicting it
+		 * while it is still in use.
+		 */
+		if (folio_test_workingset(folio))
+			return PAGEREF_ACTIVATE;
+
 		/*
 		 * Activate file-backed executable folios after first usage.
 		 */
@@ -1461,6 +1471,9 @@ static void folio_check_dirty_writeback(struct folio *folio,
 
 static struct page *alloc_demote_page(struct page *page, unsigned long node)
 {
+	struct pglist_data *pgdat = NODE_DATA(node);
+	struct page *target;
+	int z;
 	struct migration_target_control mtc = {
 		/*
 		 * Allocate from 'node', or fail quickly and quietly.
@@ -1473,7 +1486,24 @@ static struct page *alloc_demote_page(struct page *page, unsigned long node)
 		.nid = node
 	};
 
-	return alloc_migration_target(page, (unsigned long)&mtc);
+	target = alloc_migration_target(page, (unsigned long)&mtc);
+	if (target)
+		return target;
+
+	/*
+	 * The demotion target is full.  Wake its kswapd so the node makes
+	 * room - by reclaiming, or by demoting its own cold pages another
+	 * tier down - and future shrink_page_list() passes can demote
+	 * instead of swapping.  Falling back to other nodes here would
+	 * push pages sideways into the fast tier, so don't.
+	 */
+	for (z = MAX_NR_ZONES - 1; z >= 0; z--) {
+		if (managed_zone(pgdat->node_zones + z)) {
+			wakeup_kswapd(pgdat->node_zones + z, GFP_KERNEL, 0, z);
+			break;
+		}
+	}
+	return NULL;
 }
 
 /*
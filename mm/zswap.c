@@ -34,6 +34,7 @@
 #include <linux/swapops.h>
 #include <linux/writeback.h>
 #include <linux/pagemap.h>
+#include <linux/shrinker.h>
 #include <linux/workqueue.h>
 
 #include "swap.h"
@@ -1468,6 +1469,55 @@ static int __init zswap_debugfs_init(void)
 }
 #endif
 
+/*********************************
+* memory pressure shrinker
+**********************************/
+/*
+ * Writing back under memory pressure, instead of only when the pool hits
+ * zswap_max_pool_percent, keeps the pool from pinning gigabytes of
+ * long-cold compressed pages that the backing device could hold instead.
+ * zpool eviction walks the allocator's LRU and pushes the oldest entries
+ * out through zswap_writeback_entry().
+ */
+static unsigned long zswap_shrinker_count(struct shrinker *shrink,
+					  struct shrink_control *sc)
+{
+	if (!zswap_enabled || !zswap_has_pool)
+		return 0;
+
+	return DIV_ROUND_UP(zswap_pool_total_size, PAGE_SIZE);
+}
+
+static unsigned long zswap_shrinker_scan(struct shrinker *shrink,
+					 struct shrink_control *sc)
+{
+	struct zswap_pool *pool = zswap_pool_current_get();
+	unsigned long freed = 0;
+	unsigned int reclaimed;
+
+	if (!pool)
+		return SHRINK_STOP;
+
+	while (freed < sc->nr_to_scan) {
+		reclaimed = 0;
+		if (zpool_shrink(pool->zpool, 1, &reclaimed)) {
+			zswap_reject_reclaim_fail++;
+			break;
+		}
+		freed += reclaimed ? reclaimed : 1;
+	}
+	zswap_pool_put(pool);
+
+	return freed ? freed : SHRINK_STOP;
+}
+
+static struct shrinker zswap_shrinker = {
+	.count_objects = zswap_shrinker_count,
+	.scan_objects = zswap_shrinker_scan,
+	/* writeback costs a swap device write per evicted entry */
+	.seeks = DEFAULT_SEEKS * 4,
+};
+
 /*********************************
 * module init and exit
 **********************************/
@@ -1515,6 +1565,8 @@ static int __init init_zswap(void)
 	ret = frontswap_register_ops(&zswap_frontswap_ops);
 	if (ret)
 		goto destroy_wq;
+	if (register_shrinker(&zswap_shrinker))
+		pr_warn("shrinker registration failed\n");
 	if (zswap_debugfs_init())
 		pr_warn("debugfs initialization failed\n");
 	return 0;
@@ -1391,8 +1391,15 @@ static int napi_kthread_create(struct napi_struct *n)
 		err = PTR_ERR(n->thread);
 		pr_err("kthread_run failed with err %d\n", err);
 		n->thread = NULL;
+		return err;
 	}
 
+	/* Let the administrator trade packet processing capacity against
+	 * latency of competing workloads.  The poller stays a CFS citizen,
+	 * so a busy NIC degrades gracefully instead of starving userspace.
+	 */
+	sched_set_normal(n->thread, READ_ONCE(napi_threaded_nice));
+
 	return err;
 }
 
@@ -4333,6 +4340,7 @@ unsigned int sysctl_skb_defer_max __read_mostly = 64;
 int netdev_budget __read_mostly = 300;
 /* Must be at least 2 jiffes to guarantee 1 jiffy timeout */
 unsigned int __read_mostly netdev_budget_usecs = 2 * USEC_PER_SEC / HZ;
+int napi_threaded_nice __read_mostly;      /* nice value for threaded NAPI pollers */
 int weight_p __read_mostly = 64;           /* old backlog weight */
 int dev_weight_rx_bias __read_mostly = 1;  /* bias for backlog weight */
 int dev_weight_tx_bias __read_mostly = 1;  /* bias for output_queue quota */
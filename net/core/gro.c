@@ -168,11 +168,16 @@ int skb_gro_receive(struct sk_buff *p, struct sk_buff *skb)
 		return -E2BIG;
 
 	if (unlikely(p->len + len >= GRO_LEGACY_MAX_SIZE)) {
-		if (p->protocol != htons(ETH_P_IPV6) ||
-		    skb_headroom(p) < sizeof(struct hop_jumbo_hdr) ||
-		    ipv6_hdr(p)->nexthdr != IPPROTO_TCP ||
-		    p->encapsulation)
+		if (p->encapsulation)
 			return -E2BIG;
+		if (p->protocol == htons(ETH_P_IPV6)) {
+			if (skb_headroom(p) < sizeof(struct hop_jumbo_hdr) ||
+			    ipv6_hdr(p)->nexthdr != IPPROTO_TCP)
+				return -E2BIG;
+		} else if (p->protocol != htons(ETH_P_IP) ||
+			   ip_hdr(p)->protocol != IPPROTO_TCP) {
+			return -E2BIG;
+		}
 	}
 
 	lp = NAPI_GRO_CB(p)->last;
@@ -16,6 +16,7 @@
 #include <linux/vmalloc.h>
 #include <linux/init.h>
 #include <linux/slab.h>
+#include <linux/sched/prio.h>
 
 #include <net/ip.h>
 #include <net/sock.h>
@@ -26,6 +27,8 @@
 #include "dev.h"
 
 static int int_3600 = 3600;
+static int min_nice = MIN_NICE;
+static int max_nice = MAX_NICE;
 static int min_sndbuf = SOCK_MIN_SNDBUF;
 static int min_rcvbuf = SOCK_MIN_RCVBUF;
 static int max_skb_frags = MAX_SKB_FRAGS;
@@ -518,6 +521,15 @@ static struct ctl_table net_core_table[] = {
 		.mode		= 0644,
 		.proc_handler	= proc_dointvec
 	},
+	{
+		.procname	= "napi_threaded_nice",
+		.data		= &napi_threaded_nice,
+		.maxlen		= sizeof(int),
+		.mode		= 0644,
+		.proc_handler	= proc_dointvec_minmax,
+		.extra1		= &min_nice,
+		.extra2		= &max_nice,
+	},
 	{
 		.procname	= "warnings",
 		.data		= &net_msg_warn,
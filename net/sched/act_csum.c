@@ -410,7 +410,7 @@ static int tcf_csum_ipv4(struct sk_buff *skb, u32 update_flags)
 	case IPPROTO_TCP:
 		if (update_flags & TCA_CSUM_UPDATE_FLAG_TCP)
 			if (!tcf_csum_ipv4_tcp(skb, iph->ihl * 4,
-					       ntohs(iph->tot_len)))
+					       iph_totlen(skb, iph)))
 				goto fail;
 		break;
 	case IPPROTO_UDP: